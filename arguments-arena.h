@@ -0,0 +1,183 @@
+/**
+ * The size of the first block allocated by the argument arena. Later blocks
+ * are twice as large as the previous one, or as large as the allocation that
+ * caused them to be allocated.
+ */
+#ifndef ARGUMENTS_ARENA_SIZE
+    #define ARGUMENTS_ARENA_SIZE 4096
+#endif
+
+/**
+ * A type with the strictest alignment required by any value stored in the
+ * arena.
+ */
+union arguments_arena_align_t {
+    long double d;
+    long long i;
+    void *p;
+    void (*f)(void);
+};
+
+/**
+ * A block of memory allocated by the arena.
+ *
+ * The memory handed out follows the header; the union ensures that it is
+ * suitably aligned.
+ *
+ *   * next: the previously allocated block
+ *   * size: the number of bytes following the header
+ *   * used: the number of bytes handed out from this block
+ */
+union arguments_arena_block_t {
+    struct {
+        union arguments_arena_block_t *next;
+        size_t size;
+        size_t used;
+    } header;
+    union arguments_arena_align_t align;
+};
+
+/**
+ * A bump allocator for the values of arguments.
+ *
+ * Memory allocated from the arena is never freed individually; all of it is
+ * freed at once by arguments_release.
+ *
+ *   * blocks: the most recently allocated block, from which memory is handed
+ *     out
+ *   * lock: guards the arena when readers may run on several threads
+ */
+struct arguments_arena_t {
+    union arguments_arena_block_t *blocks;
+    int lock;
+};
+
+/**
+ * Locks and unlocks an arena.
+ *
+ * Allocations are short, so waiting threads only yield.
+ */
+#if ARGUMENTS_LAZY || ARGUMENTS_PARALLEL
+    #define arguments_arena_lock(arena) \
+        while (!arguments_atomic_cas(&(arena)->lock, 0, 1)) { \
+            arguments_thread_yield(); \
+        }
+    #define arguments_arena_unlock(arena) \
+        arguments_atomic_store(&(arena)->lock, 0)
+#else
+    #define arguments_arena_lock(arena)
+    #define arguments_arena_unlock(arena)
+#endif
+
+/**
+ * Allocates memory from an arena.
+ *
+ * @param arena
+ *     The arena.
+ * @param size
+ *     The number of bytes to allocate.
+ * @return suitably aligned memory, or NULL if it could not be allocated
+ */
+static ARGUMENTS_UNUSED void *
+arguments_arena_allocate(struct arguments_arena_t *arena, size_t size)
+{
+    union arguments_arena_block_t *block;
+    void *result;
+
+    /* Keep every allocation aligned */
+    size = (size + sizeof(union arguments_arena_align_t) - 1)
+        / sizeof(union arguments_arena_align_t)
+        * sizeof(union arguments_arena_align_t);
+
+    arguments_arena_lock(arena);
+
+    block = arena->blocks;
+    if (!block || (block->header.size - block->header.used < size)) {
+        size_t block_size = block
+            ? 2 * block->header.size
+            : ARGUMENTS_ARENA_SIZE;
+
+        if (block_size < size) {
+            block_size = size;
+        }
+
+        block = (union arguments_arena_block_t*)malloc(
+            sizeof(*block) + block_size);
+        if (!block) {
+            arguments_arena_unlock(arena);
+            return NULL;
+        }
+        block->header.next = arena->blocks;
+        block->header.size = block_size;
+        block->header.used = 0;
+        arena->blocks = block;
+    }
+
+    result = (char*)(block + 1) + block->header.used;
+    block->header.used += size;
+
+    arguments_arena_unlock(arena);
+
+    return result;
+}
+
+/**
+ * Copies a string into an arena.
+ *
+ * @param arena
+ *     The arena.
+ * @param s
+ *     The string to copy.
+ * @return the copy, or NULL if it could not be allocated
+ */
+static ARGUMENTS_UNUSED char *
+arguments_arena_strdup(struct arguments_arena_t *arena, const char *s)
+{
+    size_t size = strlen(s) + 1;
+    char *result = (char*)arguments_arena_allocate(arena, size);
+
+    if (result) {
+        memcpy(result, s, size);
+    }
+
+    return result;
+}
+
+/**
+ * Frees all memory allocated from an arena.
+ *
+ * @param arena
+ *     The arena.
+ */
+static void
+arguments_arena_release(struct arguments_arena_t *arena)
+{
+    while (arena->blocks) {
+        union arguments_arena_block_t *next = arena->blocks->header.next;
+
+        free(arena->blocks);
+        arena->blocks = next;
+    }
+}
+
+/**
+ * Frees all memory allocated from an arena except its largest block, which is
+ * kept for later allocations.
+ *
+ * @param arena
+ *     The arena.
+ */
+static ARGUMENTS_UNUSED void
+arguments_arena_reset(struct arguments_arena_t *arena)
+{
+    union arguments_arena_block_t *block = arena->blocks;
+
+    /* Blocks never shrink, so the most recent one is the largest */
+    if (block) {
+        arena->blocks = block->header.next;
+        arguments_arena_release(arena);
+        block->header.next = NULL;
+        block->header.used = 0;
+        arena->blocks = block;
+    }
+}
@@ -0,0 +1,305 @@
+/**
+ * Marks a function or variable as possibly unused, for optional helpers that
+ * only arguments.def may use.
+ */
+#if defined(__GNUC__)
+    #define ARGUMENTS_UNUSED __attribute__((unused))
+#else
+    #define ARGUMENTS_UNUSED
+#endif
+
+/**
+ * This is the macro used to define command line parameters. Create the file
+ * arguments.def and populate it with invocations of this macro.
+ *
+ * The order of the arguments found in arguments.def needs to reflect the
+ * parameters to to the run function if ARGUMENTS_AUTOMATIC is defined.
+ *
+ * @param type
+ *     The type of the variable that stores the parsed value of this argument.
+ *
+ * @param name
+ *     The name of the variable, and also the long argument name. The long
+ *     argument name is constructed by prepending two dashes to the name and
+ *     then replacing all underscores with dashes.
+ *
+ * @param short
+ *     The short command line argument name. This may not be NULL; use
+ *     ARGUMENT_NO_SHORT_OPTION if the argument hs no short option.
+ *
+ * @param help
+ *     The help text for the argument. The first occurrence of "%s" in this
+ *     message will be replaced by the default value.
+ *
+ * @param value_count
+ *     The number of parameters following the named parameter that are required.
+ *
+ * @param is_required
+ *     Whether this argument is required on the command line. The value for
+ *     is_required is evaluated once all arguments have been read, so it may
+ *     depend on arguments passed on the command line.
+ *
+ * @param set_default
+ *     A list of statements executed when the argument has not been passed on
+ *     the command line. The following variables are available to the code:
+ *       - type *target: a pointer to the variable to receive the value.
+ *       - struct arguments_arena_t *arena: the arena from which memory may be
+ *         allocated with arguments_arena_allocate.
+ *     If there is not suitable default value for the argument, pass
+ *     ARGUMENTS_NO_DEFAULT.
+ *
+ * @param read
+ *     A list of statements used to actually set the value of the variable. The
+ *     following variables are available to the code:
+ *       - type *target: a pointer to the variable to receive the value.
+ *       - const char **value_strings: the actual values passed.
+ *       - int value_strings_length: the number of values passed.
+ *       - struct arguments_arena_t *arena: the arena from which memory may be
+ *         allocated with arguments_arena_allocate.
+ *       - int is_valid: whether the value passed was valid; set this to 0 if
+ *         the argument variable could not be initialised.
+ *
+ * @param release
+ *     A list of statements used to release any resources used by the variable;
+ *     this may be closing files, or freeing allocated memory. The following
+ *     variables are available to the code:
+ *       - type *target: a pointer to the variable that received the value.
+ */
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+    set_default, read, release)
+
+/**
+ * This is the macro used to separate command line parameters into natural
+ * sections. Use this macro to group arguments.
+ *
+ * The group is only used when printing the help text.
+ *
+ * @param text
+ *     The text to insert before the section is displayed.
+ */
+#define ARGUMENT_SECTION(text)
+
+/**
+ * This is the macro used to set flags for an argument. Use this macro in
+ * arguments.def after the argument has been defined.
+ *
+ * An argument may have several invocations of this macro; all flags are
+ * combined.
+ *
+ * @param name
+ *     The name of the argument.
+ * @param flags
+ *     The flags to set. This is a combination of the ARGUMENT_ACCUMULATE,
+ *     ARGUMENT_INDEPENDENT, ARGUMENT_ASYNC, ARGUMENT_NO_RELEASE and
+ *     ARGUMENT_DEBUG_RELEASE flags.
+ */
+#define ARGUMENT_FLAGS(name, flags)
+
+/**
+ * This is the macro used to declare that the reader of an argument depends on
+ * the value of another argument. Use this macro in arguments.def after both
+ * arguments have been defined.
+ *
+ * Dependencies are only used when ARGUMENTS_PARALLEL is non-zero; otherwise
+ * arguments are always converted in the order they are defined.
+ *
+ * @param name
+ *     The name of the argument.
+ * @param dependency
+ *     The name of the argument that must be converted before name.
+ */
+#define ARGUMENT_DEPENDS(name, dependency)
+
+/**
+ * This is the macro used to start the arguments of a command, such as build in
+ * "tool build --jobs 4". Every argument following this macro in arguments.def
+ * belongs to the command, up to the next invocation; the arguments preceding
+ * the first invocation are global.
+ *
+ * The first positional argument on the command line selects the command.
+ * Global arguments are matched anywhere, but the arguments of a command only
+ * once it has been selected, and only the global arguments and those of the
+ * selected command are converted, checked and released.
+ *
+ * @param name
+ *     The name of the command. The command line argument selecting the command
+ *     is constructed by replacing all underscores with dashes. The constant
+ *     ACMD_name is defined for the command.
+ * @param help
+ *     The help text for the command.
+ */
+#define ARGUMENT_COMMAND(name, help)
+
+/**
+ * This is the macro used to let the value of an argument be saved in a
+ * snapshot with arguments_save_snapshot, and loaded from it instead of being
+ * converted. Use this macro in arguments.def after the argument has been
+ * defined.
+ *
+ * This is only used when ARGUMENTS_SNAPSHOTS is non-zero.
+ *
+ * @param name
+ *     The name of the argument.
+ * @param save
+ *     A list of statements saving the value. The following variables are
+ *     available to the code:
+ *       - const type *target: a pointer to the value.
+ *       - struct arguments_snapshot_writer_t *writer: the snapshot, to which
+ *         data is appended with arguments_snapshot_write(writer, data, size).
+ *     Pass ARGUMENT_SAVE_PLAIN, ARGUMENT_SAVE_STRING or ARGUMENT_SAVE_LIST for
+ *     values without pointers, strings and lists.
+ * @param load
+ *     A list of statements loading the value. The following variables are
+ *     available to the code:
+ *       - type *target: a pointer to the variable to receive the value.
+ *       - char *data: the data saved; it remains valid for as long as the
+ *         snapshot, and may be modified.
+ *       - size_t size: the size of data.
+ *       - struct arguments_arena_t *arena: the arena of the context.
+ *       - int is_valid: set this to 0 if the value could not be loaded, in
+ *         which case it is converted instead.
+ *     Pass ARGUMENT_LOAD_PLAIN, ARGUMENT_LOAD_STRING or ARGUMENT_LOAD_LIST to
+ *     match the ready-made save blocks.
+ */
+#define ARGUMENT_SNAPSHOT(name, save, load)
+
+/**
+ * Pass this flag to ARGUMENT_FLAGS to accumulate the values of all
+ * occurrences of the argument.
+ *
+ * When the command line is read with arguments_scan, value_strings will
+ * contain the values of all occurrences in the order they were passed,
+ * instead of only those of the last occurrence.
+ */
+#define ARGUMENT_ACCUMULATE 1
+
+/**
+ * Pass this flag to ARGUMENT_FLAGS if the reader of the argument may run on a
+ * worker thread, concurrently with other readers.
+ *
+ * This is only used when ARGUMENTS_PARALLEL is non-zero.
+ */
+#define ARGUMENT_INDEPENDENT 2
+
+/**
+ * Pass this flag to ARGUMENT_FLAGS to start converting the argument on a
+ * background thread in arguments_set, so that it may be ready by the time it
+ * is first read. ARGUMENT_VALUE waits for the conversion to complete.
+ *
+ * This is only used when ARGUMENTS_LAZY is non-zero.
+ */
+#define ARGUMENT_ASYNC 4
+
+/**
+ * Pass this flag to ARGUMENT_FLAGS if release of the argument need not be
+ * executed when the process terminates, since the operating system reclaims
+ * what it would free.
+ *
+ * The argument is still released by arguments_reset_ctx and
+ * arguments_release_ctx.
+ */
+#define ARGUMENT_NO_RELEASE 8
+
+/**
+ * Pass this flag to ARGUMENT_FLAGS if release of the argument need only be
+ * executed when the process terminates if ARGUMENTS_LEAK_CHECK is non-zero.
+ */
+#define ARGUMENT_DEBUG_RELEASE 16
+
+/**
+ * Pass this value as value_count if the argument should read all command line
+ * arguments up to the next command line argument starting with "-".
+ */
+#define ARGUMENT_VARIADIC (-1)
+
+/**
+ * Pass this value as short if the argument does not have a short name.
+ */
+#define ARGUMENT_NO_SHORT_OPTION ""
+
+/**
+ * Pass this value as is_required to the ARGUMENT macro if the argument is
+ * required.
+ */
+#define ARGUMENT_IS_REQUIRED 1
+
+/**
+ * Pass this value as is_required to the ARGUMENT macro if the argument is not
+ * required.
+ */
+#define ARGUMENT_IS_OPTIONAL 0
+
+/**
+ * The type of an argument holding a list of values, as read by the list
+ * readers such as ARGUMENT_READ_INT_LIST.
+ *
+ *   * values: the values, allocated from the arena of the context and
+ *     released with it, so they must not be passed to free
+ *   * length: the number of values
+ *
+ * @param type
+ *     The type of the values.
+ */
+#define ARGUMENT_LIST(type) \
+    struct { \
+        type *values; \
+        size_t length; \
+    }
+
+/**
+ * A closed interval of unsigned integers, as read by
+ * ARGUMENT_READ_RANGE_LIST.
+ */
+struct arguments_interval_t {
+    unsigned long long first;
+    unsigned long long last;
+};
+
+/**
+ * The sources of argument values, in order of increasing precedence.
+ */
+enum {
+    /**
+     * The argument was not passed, so its value is set by set_default.
+     */
+    AS_DEFAULT,
+
+    /**
+     * The value was read from a configuration file.
+     */
+    AS_FILE,
+
+    /**
+     * The value was read from an environment variable.
+     */
+    AS_ENVIRONMENT,
+
+    /**
+     * The value was passed on the command line.
+     */
+    AS_COMMAND_LINE
+};
+
+/**
+ * Return values used by arguments_validate and arguments_parse.
+ */
+enum {
+    /**
+     * The operation completed successfully.
+     */
+    AC_OK,
+
+    /**
+     * An invalid value was passed on the command line, or a required argument
+     * was missing.
+     */
+    AC_ERROR,
+
+    /**
+     * The command line argument --help was found, and the help message was
+     * printed.
+     *
+     * Unless ARGUMENTS_PRINT_HELP is non-zero, this value will not be returned.
+     */
+    AC_HELP
+};
@@ -0,0 +1,55 @@
+/**
+ * Prints the completions of a partial command line, one per line.
+ *
+ * The last word of the command line is completed. The long arguments and, if
+ * no command has been selected, the commands starting with it are printed.
+ * Like arguments_scan, the first preceding word not starting with "-" selects
+ * a command if it names one; only the global arguments and those of that
+ * command are completed. The command line is not otherwise parsed.
+ *
+ * The long arguments are found with a binary search in arguments_sorted, so a
+ * completion takes time proportional to the length of the word and the number
+ * of completions, plus a logarithmic term.
+ *
+ * @param argc, argv
+ *     The words of the command line following the program name, for example
+ *     "${COMP_WORDS[@]:1:COMP_CWORD}" in a bash completion function. If argc is
+ *     0, everything is completed.
+ * @param stream
+ *     The stream to print to.
+ */
+static ARGUMENTS_UNUSED void
+arguments_complete(int argc, char *argv[], FILE *stream)
+{
+    const char *word = (argc > 0) ? argv[argc - 1] : "";
+    size_t length = strlen(word);
+    int i, position, count, command;
+
+    arguments_prepare();
+
+    command = ACMD_NONE;
+    for (i = 0; i < argc - 1; i++) {
+        if (!arguments_is_option(argv[i])) {
+            command = arguments_lookup_command(argv[i]);
+            break;
+        }
+    }
+
+    if (!length || (word[0] == '-')) {
+        for (position = arguments_lookup_prefix(word, length, &count); count--;
+                position++) {
+            if (arguments_is_visible(arguments_sorted[position], command)) {
+                fprintf(stream, "%s\n",
+                    arguments_long_names[arguments_sorted[position]]);
+            }
+        }
+    }
+
+    if (command == ACMD_NONE) {
+        for (i = ACMD_NONE + 1; i < ARGUMENTS_COMMAND_COUNT; i++) {
+            if (strncmp(arguments_command_names[i], word, length) == 0) {
+                fprintf(stream, "%s\n", arguments_command_names[i]);
+            }
+        }
+    }
+}
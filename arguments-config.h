@@ -0,0 +1,240 @@
+#if defined(WIN32)
+    #include <windows.h>
+#else
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+/**
+ * Maps a configuration file into the memory of a context.
+ *
+ * The mapping is private, so the file is not modified when the lines are
+ * terminated in place.
+ *
+ * @param ctx
+ *     The context.
+ * @param path
+ *     The path of the file.
+ * @return AC_OK if the file was mapped or does not exist, or AC_ERROR if it
+ *     could not be read
+ */
+static int
+arguments_config_map(struct arguments_context_t *ctx, const char *path)
+{
+#if defined(WIN32)
+    HANDLE file, mapping;
+    LARGE_INTEGER size;
+
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        DWORD error = GetLastError();
+
+        return ((error == ERROR_FILE_NOT_FOUND)
+                || (error == ERROR_PATH_NOT_FOUND))
+            ? AC_OK
+            : AC_ERROR;
+    }
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return AC_ERROR;
+    }
+    else if (!size.QuadPart) {
+        CloseHandle(file);
+        return AC_OK;
+    }
+
+    /* The view keeps the mapping and the file open once they are closed */
+    mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) {
+        return AC_ERROR;
+    }
+    ctx->config = (char*)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!ctx->config) {
+        return AC_ERROR;
+    }
+    ctx->config_size = (size_t)size.QuadPart;
+#else
+    struct stat info;
+    void *config;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return (errno == ENOENT) ? AC_OK : AC_ERROR;
+    }
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return AC_ERROR;
+    }
+    else if (!info.st_size) {
+        close(fd);
+        return AC_OK;
+    }
+
+    config = mmap(NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+        0);
+    close(fd);
+    if (config == MAP_FAILED) {
+        return AC_ERROR;
+    }
+    ctx->config = (char*)config;
+    ctx->config_size = info.st_size;
+#endif
+
+    return AC_OK;
+}
+
+/**
+ * Unmaps the configuration file of a context, if any.
+ *
+ * @param ctx
+ *     The context.
+ */
+static void
+arguments_config_unmap(struct arguments_context_t *ctx)
+{
+    if (ctx->config) {
+#if defined(WIN32)
+        UnmapViewOfFile(ctx->config);
+#else
+        munmap(ctx->config, ctx->config_size);
+#endif
+        ctx->config = NULL;
+        ctx->config_size = 0;
+    }
+}
+
+/**
+ * Determines whether a character is a space or a tab.
+ */
+#define arguments_config_is_blank(c) \
+    (((c) == ' ') || ((c) == '\t'))
+
+/**
+ * Reads the arguments that have not been passed on the command line or in the
+ * environment from a configuration file.
+ *
+ * Every line of the file is either empty, a comment starting with "#" or ";",
+ * or on the form "name = value", where name is the name of an argument and
+ * dashes and underscores are equivalent. The value extends to the end of the
+ * line and is treated like a single value following the argument on the
+ * command line, so an argument with value_count 0 is present if it is listed,
+ * and arguments with a value_count greater than 1 cannot be set in the file.
+ * Lines with unknown names are ignored; if a name is listed several times, the
+ * last value is used.
+ *
+ * The file is mapped into memory and the values are terminated in place, so
+ * they remain valid until the context is reset or released. Only one file can
+ * be read into a context before it is reset.
+ *
+ * @param ctx
+ *     The context.
+ * @param path
+ *     The path of the file. If the file does not exist, nothing is read.
+ * @return AC_OK, or AC_ERROR if the file could not be read, a line is not on
+ *     the expected form, memory could not be allocated or a file has already
+ *     been read
+ */
+static int
+arguments_read_config(struct arguments_context_t *ctx, const char *path)
+{
+    char *line, *end;
+    int result;
+
+    if (ctx->config) {
+        return AC_ERROR;
+    }
+    result = arguments_config_map(ctx, path);
+    if ((result != AC_OK) || !ctx->config) {
+        return result;
+    }
+
+    end = ctx->config + ctx->config_size;
+    for (line = ctx->config; line < end;) {
+        char *line_end = (char*)memchr(line, '\n', end - line);
+        char *name, *name_end, *value, *value_end, **values;
+        int index, count;
+
+        if (!line_end) {
+            line_end = end;
+        }
+
+        /* Skip blank lines and comments */
+        name = line;
+        line = (line_end < end) ? line_end + 1 : end;
+        while ((name < line_end) && arguments_config_is_blank(*name)) {
+            name++;
+        }
+        if ((name == line_end) || (*name == '#') || (*name == ';')
+                || (*name == '\r')) {
+            continue;
+        }
+
+        /* Find the name and the value */
+        value = (char*)memchr(name, '=', line_end - name);
+        if (!value) {
+            return AC_ERROR;
+        }
+        name_end = value++;
+        while ((name_end > name) && arguments_config_is_blank(name_end[-1])) {
+            name_end--;
+        }
+        while ((value < line_end) && arguments_config_is_blank(*value)) {
+            value++;
+        }
+        value_end = line_end;
+        while ((value_end > value) && (arguments_config_is_blank(value_end[-1])
+                || (value_end[-1] == '\r'))) {
+            value_end--;
+        }
+
+        /* The command line and the environment take precedence */
+        index = arguments_lookup_name(name, name_end - name, 0,
+            ctx->state->command);
+        if ((index < 0)
+                || (arguments_bit_get(ctx->state->present, index)
+                    && (ctx->state->sources[index] != AS_FILE))) {
+            continue;
+        }
+
+        values = (char**)arguments_arena_allocate(&ctx->arena,
+            sizeof(*values));
+        if (!values) {
+            return AC_ERROR;
+        }
+
+        /* The value is terminated in place, unless it extends to the end of
+           the file, where there is no room for the terminator */
+        if (value_end < end) {
+            *value_end = '\0';
+            *values = value;
+        }
+        else {
+            *values = (char*)arguments_arena_allocate(&ctx->arena,
+                value_end - value + 1);
+            if (!*values) {
+                return AC_ERROR;
+            }
+            memcpy(*values, value, value_end - value);
+            (*values)[value_end - value] = '\0';
+        }
+
+        count = arguments_value_count(index, 1, values, 0);
+        if (count < 0) {
+            continue;
+        }
+
+        arguments_bit_set(ctx->state->present, index);
+        ctx->state->sources[index] = AS_FILE;
+        ctx->state->strings[index].value_strings = values;
+        ctx->state->strings[index].value_strings_length = count;
+    }
+
+    return AC_OK;
+}
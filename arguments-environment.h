@@ -0,0 +1,77 @@
+/**
+ * The environment of the process.
+ */
+#if defined(WIN32)
+    #define arguments_environ _environ
+#else
+    extern char **environ;
+    #define arguments_environ environ
+#endif
+
+/**
+ * Reads the arguments that have not been passed on the command line from the
+ * environment.
+ *
+ * The environment variable of an argument is its name in upper case, prefixed
+ * by ARGUMENTS_ENVIRONMENT_PREFIX. Its value is treated like a single value
+ * following the argument on the command line, so an argument with value_count
+ * 0 is present if the variable is set, and arguments with a value_count
+ * greater than 1 cannot be set from the environment.
+ *
+ * The environment is walked once, and every variable name is looked up like a
+ * long argument.
+ *
+ * @param ctx
+ *     The context.
+ * @return AC_OK, or AC_ERROR if memory could not be allocated
+ */
+static int
+arguments_read_environment(struct arguments_context_t *ctx)
+{
+    const size_t prefix_length = sizeof(ARGUMENTS_ENVIRONMENT_PREFIX) - 1;
+    char **variable;
+
+    if (!arguments_environ) {
+        return AC_OK;
+    }
+
+    for (variable = arguments_environ; *variable; variable++) {
+        const char *name = *variable + prefix_length, *separator;
+        char **value;
+        int index, count;
+
+        if (strncmp(*variable, ARGUMENTS_ENVIRONMENT_PREFIX,
+                prefix_length) != 0) {
+            continue;
+        }
+        separator = strchr(name, '=');
+        if (!separator) {
+            continue;
+        }
+
+        /* The command line takes precedence over the environment */
+        index = arguments_lookup_name(name, separator - name, 1,
+            ctx->state->command);
+        if ((index < 0) || arguments_bit_get(ctx->state->present, index)) {
+            continue;
+        }
+
+        value = (char**)arguments_arena_allocate(&ctx->arena, sizeof(*value));
+        if (!value) {
+            return AC_ERROR;
+        }
+        *value = (char*)separator + 1;
+
+        count = arguments_value_count(index, 1, value, 0);
+        if (count < 0) {
+            continue;
+        }
+
+        arguments_bit_set(ctx->state->present, index);
+        ctx->state->sources[index] = AS_ENVIRONMENT;
+        ctx->state->strings[index].value_strings = value;
+        ctx->state->strings[index].value_strings_length = count;
+    }
+
+    return AC_OK;
+}
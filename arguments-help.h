@@ -1,24 +1,87 @@
-#include <ctype.h>
-#include <wchar.h>
+#include "arguments-layout.h"
 
 /**
- * Returns the width of the terminal.
+ * Returns the name of a field of struct arguments_help_texts_t for the
+ * ARGUMENT_SECTION invoked on a line of arguments.def.
+ */
+#define arguments_help_section_field(line) \
+    arguments_help_section_field_of(line)
+#define arguments_help_section_field_of(line) \
+    section_##line
+
+#if ARGUMENTS_COLD_HELP
+/**
+ * The attribute placing the help texts in a section of their own if
+ * ARGUMENTS_COLD_HELP is non-zero.
+ */
+#ifndef ARGUMENTS_COLD_SECTION
+    #if defined(__GNUC__) && defined(__ELF__)
+        #define ARGUMENTS_COLD_SECTION \
+            __attribute__((section("arguments_help")))
+    #else
+        #define ARGUMENTS_COLD_SECTION
+    #endif
+#endif
+
+/**
+ * All help texts, stored contiguously in the order they are rendered.
  *
- * @return the width of the terminal, or (unsigned int)-1 if it cannot be
- *   determined
+ * Every text is a field sized to fit it, so the texts are not interleaved
+ * with the names and other strings read when parsing, and stay on pages of
+ * their own. The help of ARGUMENT_SECTION invocations is named after the line
+ * of the invocation, so at most one may be invoked per line.
  */
-static unsigned int
-arguments_terminal_width(void)
-{
-    char *columns = getenv("COLUMNS");
-    int result = columns ? atoi(columns) : 80;
+struct arguments_help_texts_t {
+#ifdef ARGUMENTS_HELP
+    char header[sizeof(ARGUMENTS_HELP)];
+#endif
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    char help_##name[sizeof(help)];
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text) \
+    char arguments_help_section_field(__LINE__)[sizeof(text)];
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help) \
+    char command_##name[sizeof(help)];
+#include "../arguments.def"
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help)
+    char end;
+};
 
-    if (!result) {
-        result = (unsigned int)-1;
-    }
+static const struct arguments_help_texts_t ARGUMENTS_COLD_SECTION
+arguments_help_texts = {
+#ifdef ARGUMENTS_HELP
+    ARGUMENTS_HELP,
+#endif
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    help,
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text) \
+    text,
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help) \
+    help,
+#include "../arguments.def"
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help)
+    '\0'
+};
 
-    return result;
-}
+/**
+ * Returns a help text, given its field in arguments_help_texts and the text
+ * itself.
+ */
+#define arguments_help_text_of(field, text) \
+    (arguments_help_texts.field)
+#else
+#define arguments_help_text_of(field, text) \
+    (text)
+#endif
 
 /**
  * Returns the number of characters needed for the argument names header.
@@ -28,6 +91,12 @@ arguments_terminal_width(void)
 static unsigned int
 argument_header_width(void)
 {
+#if defined(__cplusplus) && (__cplusplus >= 201402L)
+    /* The width is known at compile time */
+    static constexpr unsigned int result = arguments_static_header_width();
+
+    return result;
+#else
     unsigned int current;
     unsigned int result;
 
@@ -37,7 +106,7 @@ argument_header_width(void)
 #undef ARGUMENT
 #define ARGUMENT(type, name, short, value_count, is_required, help, \
         set_default, read, release) \
-    current = 2 + strlen(#name); \
+    current = arguments_descriptors[AI_##name].long_length; \
     if (short) { \
         current += 2 + strlen(short ? short : ""); \
     } \
@@ -49,232 +118,153 @@ argument_header_width(void)
 #include "../arguments.def"
 
     return result;
+#endif
 }
 
-#define isend(c) \
-    (((c) == 0) || ((c) == '\n'))
-
 /**
- * Determines the number of characters starting at s to print and the offset to
- * the next line.
- *
- * @param s
- *     The string to investigate. *s has to point to the first character of a
- *     line.
- * @param length
- *     The number of characters to print is written to this variable.
- * @param max_width
- *     The maximum number of characters to print.
- * @return the offset to the beginning of the next line
+ * Renders the help for all commands.
  *
+ * @param buffer
+ *     The buffer to render into.
+ * @param terminal_width
+ *     The width of the terminal.
  */
-static unsigned int
-arguments_get_line(const char *s, unsigned int *length,
-    unsigned int max_length)
+static void
+arguments_render_help(struct arguments_help_buffer_t *buffer,
+    unsigned int terminal_width)
 {
-    mbstate_t mbs;
-    int was_space, seen_space;
-    unsigned int end, l, i, result;
-
-    /* Initialise the multibyte state */
-    memset(&mbs, 0, sizeof(mbs));
-    if (!mbsinit(&mbs)) {
-        char outbuf[8];
-        const wchar_t empty[] = L"";
-        const wchar_t *srcp = empty;
-        wcsrtombs(outbuf, &srcp, sizeof(outbuf), &mbs);
-    }
-
-    *length = 0;
-    was_space = 0;
-    seen_space = 0;
-    end = strlen(s);
-    l = 0;
-    i = 0;
-    result = 0;
-
-    for (i = 0; (i < end) && (l < max_length);) {
-        int is_space;
-        size_t di;
-
-        /* Break immediately if we reach newline */
-        if (s[i] == '\n') {
-            *length = l;
-            result = i + 1;
-            break;
-        }
+    /* Determine how many columns we need for the argument names */
+    unsigned int header_width = argument_header_width();
 
-        if (!seen_space) {
-            /* If we have not yet encountered any space, we have to update the
-               length of the line, since the word will then have to be squeezed
-               in */
-            *length = l;
-            result = i;
-        }
+#ifdef ARGUMENTS_HELP
+    /* Render the help header */
+    arguments_render_help_string(buffer, NULL, NULL,
+        arguments_help_text_of(header, ARGUMENTS_HELP), 0, terminal_width);
+#endif
 
-        /* We are processing a character; increase the length */
-        l++;
+    /* Render the argument help strings, and those of the commands before
+       their arguments */
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    arguments_render_help_string(buffer, arguments_long_names[AI_##name], \
+        short, arguments_help_text_of(help_##name, help), header_width, \
+        terminal_width);
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text) \
+    arguments_help_append(buffer, "\n", 1); \
+    arguments_render_help_string(buffer, NULL, NULL, \
+        arguments_help_text_of(arguments_help_section_field(__LINE__), \
+            text), \
+        0, terminal_width);
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help) \
+    arguments_help_append(buffer, "\n", 1); \
+    arguments_render_help_string(buffer, \
+        arguments_command_names[ACMD_##name], NULL, \
+        arguments_help_text_of(command_##name, help), header_width, \
+        terminal_width);
+#include "../arguments.def"
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help)
+}
 
-        is_space = isspace(s[i]);
-        seen_space |= is_space;
-        if (is_space && !was_space) {
-            /* If the current character is space following non-space, the
-               previous character was the last character of a word and we update
-               the length */
-            *length = l - 1;
-        }
-        else if (!is_space && was_space) {
-            /* If this is a non-space character following a space character,
-               this is the first character of a word and we update the offset of
-               the next line */
-            result = i;
-        }
-        was_space = is_space;
+/**
+ * The help rendered for the terminal width it was last requested for.
+ *
+ *   * buffer: the rendered help
+ *   * terminal_width: the terminal width buffer was rendered for
+ */
+static struct {
+    struct arguments_help_buffer_t buffer;
+    unsigned int terminal_width;
+} arguments_help_cache;
 
-        /* Calculate how many bytes we need to increment our position for the
-           current character */
-        di = mbrlen(s + i, end - i, &mbs);
-        switch (di) {
-        case 0:
-            /* This should really not happen */
-            break;
+/**
+ * The mutex held while the help cache is used, so that --help may be passed
+ * on several threads at once.
+ */
+static arguments_static_mutex_t arguments_help_mutex =
+    ARGUMENTS_STATIC_MUTEX_INIT;
 
-        case (size_t)-1:
-            /* Invalid character sequence; skip to the next byte */
-            i++;
-            break;
+/**
+ * Returns the help for all commands from the cache, rendering it first if the
+ * width of the terminal has changed since it was last rendered.
+ *
+ * arguments_help_mutex must be held.
+ *
+ * @param length
+ *     The length of the help is written to this variable.
+ * @return the help, which is not terminated, or NULL if memory could not be
+ *     allocated
+ */
+static const char *
+arguments_help_cached(size_t *length)
+{
+    unsigned int terminal_width;
 
-        case (size_t)-2:
-            /* Possibly incomplete multi byte sequence; skip to the next
-               byte */
-            i++;
-            break;
+    /* Make sure that the long arguments have been generated */
+    arguments_prepare();
 
-        default:
-            i += di;
-        }
+    /* Determine the width of the terminal */
+    terminal_width = arguments_terminal_width();
 
-        /* If this is the last character of the string, we update length and
-           result to make sure that all characters are included and the caller
-           knows that the string has been terminated */
-        if (i == end) {
-            *length = l;
-            result = i;
+    if (!arguments_help_cache.buffer.data
+            || (arguments_help_cache.terminal_width != terminal_width)) {
+        arguments_help_cache.buffer.length = 0;
+        arguments_help_cache.buffer.is_valid = 1;
+        arguments_help_cache.terminal_width = terminal_width;
+        arguments_render_help(&arguments_help_cache.buffer, terminal_width);
+        if (!arguments_help_cache.buffer.is_valid) {
+            free(arguments_help_cache.buffer.data);
+            memset(&arguments_help_cache, 0, sizeof(arguments_help_cache));
+            return NULL;
         }
     }
 
-    /* If result is less than length, we have stopped before reaching a new
-       word */
-    if (result < *length) {
-        result = *length;
-    }
-
-    /* Skip any trailing space so that the next offset will be the start of a
-       word or the end of the string */
-    while ((result < end) && (s[result] == ' ')) result++;
+    *length = arguments_help_cache.buffer.length;
 
-    return result;
+    return arguments_help_cache.buffer.data;
 }
 
 /**
- * Prints the help for a single argument.
+ * Returns the help for all commands, rendered for the width of the terminal.
  *
- * @param header
- *     The argument header. This should be "--long-name" or "--long-name, -s".
- *     This parameter is optional and may be NULL if only the help should be
- *     printed. In that case, header_width is set to 0.
- * @param help
- *     The help string.
- * @param header_width
- *     The width of the header column.
- * @param terminal_width
- *     The width of the terminal.
+ * The help is only rendered again if the width of the terminal has changed
+ * since the last call. The returned help remains valid until it is rendered
+ * again, so threads that may see different terminal widths should call
+ * arguments_print_help instead, which holds the lock while writing.
+ *
+ * @param length
+ *     The length of the help is written to this variable.
+ * @return the help, which is not terminated, or NULL if memory could not be
+ *     allocated
  */
-static void
-arguments_print_help_string(const char *header, const char *help,
-    unsigned int header_width, unsigned int terminal_width)
+static ARGUMENTS_UNUSED const char *
+arguments_help_text(size_t *length)
 {
-    const char *c;
+    const char *text;
 
-    /* Print the header, which is the argument names left aligned and padded up
-       to names_width characters */
-    if (header) {
-        printf("\n%-*s ", header_width, header);
-    }
-    else {
-        header_width = 0;
-    }
+    arguments_static_mutex_lock(&arguments_help_mutex);
+    text = arguments_help_cached(length);
+    arguments_static_mutex_unlock(&arguments_help_mutex);
 
-    c = help;
-    while (*c) {
-        unsigned int n, length;
-
-        /* Get the length of the current line, and the offset of the start of
-           the next line */
-        n = arguments_get_line(c, &length, terminal_width - header_width - 1);
-
-        /* Print at most length charaters from the current offset in the help
-           string */
-        printf("%-.*s", length, c);
-
-        /* Do not print newline when the string covers the entire line */
-        if (length < terminal_width - header_width - (header ? 1 : 0)) {
-            printf("\n");
-        }
-        c += n;
-
-        /* If we have not reached the end of the help string, print a new empty
-           header column; do not do this if no header has been specified */
-        if (*c && header) {
-            unsigned int i;
-
-            for (i = 0; i <= header_width; i++) {
-                putc(' ', stdout);
-            }
-        }
-    }
+    return text;
 }
 
 /**
- * Prints the help for all commands.
+ * Prints the help for all commands with a single write.
  */
 static void
 arguments_print_help(void)
 {
-    unsigned int terminal_width;
-    int header_width;
-    char header[128], *h;
-
-    /* Determine the width of the terminal */
-    terminal_width = arguments_terminal_width();
-
-    /* Determine how many columns we need for the argument names */
-    header_width = argument_header_width();
+    size_t length;
+    const char *text;
 
-#ifdef ARGUMENTS_HELP
-    /* Print the help header */
-    arguments_print_help_string(NULL, ARGUMENTS_HELP, 0, terminal_width);
-#endif
-
-    /* Print the argument help strings */
-#undef ARGUMENT
-#define ARGUMENT(type, name, short, help, value_count, is_required, \
-        set_default, read, release) \
-    if (short) { \
-        snprintf(header, sizeof(header), "--%s, %s", #name, short); \
-    } \
-    else { \
-        snprintf(header, sizeof(header), "--%s", #name); \
-    } \
-    for (h = header; *h; h++) { \
-        if (*h == '_') { \
-            *h = '-'; \
-        } \
-    } \
-    arguments_print_help_string(header, help, header_width, terminal_width);
-#undef ARGUMENT_SECTION
-#define ARGUMENT_SECTION(text) \
-    printf("\n"); \
-    arguments_print_help_string(NULL, text, 0, terminal_width);
-#include "../arguments.def"
+    arguments_static_mutex_lock(&arguments_help_mutex);
+    text = arguments_help_cached(&length);
+    if (text) {
+        fwrite(text, 1, length, stdout);
+    }
+    arguments_static_mutex_unlock(&arguments_help_mutex);
 }
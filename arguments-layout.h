@@ -0,0 +1,375 @@
+#include <ctype.h>
+#include <wchar.h>
+
+/**
+ * Returns the width of the terminal.
+ *
+ * @return the width of the terminal, or (unsigned int)-1 if it cannot be
+ *   determined
+ */
+static unsigned int
+arguments_terminal_width(void)
+{
+    char *columns = getenv("COLUMNS");
+    int result = columns ? atoi(columns) : 80;
+
+    if (!result) {
+        result = (unsigned int)-1;
+    }
+
+    return result;
+}
+
+#define isend(c) \
+    (((c) == 0) || ((c) == '\n'))
+
+/**
+ * Returns the number of ASCII characters at the start of a string.
+ *
+ * Eight bytes are examined at a time, so that runs of ASCII text, which need
+ * no multibyte decoding, are skipped quickly.
+ *
+ * @param s
+ *     The string to investigate.
+ * @param size
+ *     The maximum number of bytes to examine.
+ * @return the number of bytes before the first byte with the high bit set, or
+ *     size if there is none
+ */
+static size_t
+arguments_ascii_length(const char *s, size_t size)
+{
+    const unsigned long long high = 0x8080808080808080ULL;
+    size_t i;
+
+    for (i = 0; i + sizeof(high) <= size; i += sizeof(high)) {
+        unsigned long long word;
+
+        memcpy(&word, s + i, sizeof(word));
+        if (word & high) {
+            break;
+        }
+    }
+    while ((i < size) && !(s[i] & 0x80)) {
+        i++;
+    }
+
+    return i;
+}
+
+/**
+ * Determines the number of characters starting at s to print and the offset to
+ * the next line.
+ *
+ * ASCII characters are counted without decoding; mbrlen is only called for
+ * the other characters. The work done is proportional to the length of the
+ * line, not to the length of the remaining string.
+ *
+ * @param s
+ *     The string to investigate. *s has to point to the first character of a
+ *     line.
+ * @param end
+ *     The number of bytes remaining in the string starting at s.
+ * @param length
+ *     The number of characters to print is written to this variable.
+ * @param max_width
+ *     The maximum number of characters to print.
+ * @return the offset to the beginning of the next line
+ *
+ */
+static unsigned int
+arguments_get_line(const char *s, size_t end, unsigned int *length,
+    unsigned int max_length)
+{
+    mbstate_t mbs;
+    int was_space, seen_space;
+    unsigned int l, i, result;
+    size_t ascii_end;
+
+    /* Initialise the multibyte state */
+    memset(&mbs, 0, sizeof(mbs));
+    if (!mbsinit(&mbs)) {
+        char outbuf[8];
+        const wchar_t empty[] = L"";
+        const wchar_t *srcp = empty;
+        wcsrtombs(outbuf, &srcp, sizeof(outbuf), &mbs);
+    }
+
+    *length = 0;
+    was_space = 0;
+    seen_space = 0;
+    l = 0;
+    i = 0;
+    ascii_end = 0;
+    result = 0;
+
+    for (i = 0; (i < end) && (l < max_length);) {
+        int is_space;
+        size_t di;
+
+        /* Break immediately if we reach newline */
+        if (s[i] == '\n') {
+            *length = l;
+            result = i + 1;
+            break;
+        }
+
+        if (!seen_space) {
+            /* If we have not yet encountered any space, we have to update the
+               length of the line, since the word will then have to be squeezed
+               in */
+            *length = l;
+            result = i;
+        }
+
+        /* We are processing a character; increase the length */
+        l++;
+
+        is_space = isspace((unsigned char)s[i]);
+        seen_space |= is_space;
+        if (is_space && !was_space) {
+            /* If the current character is space following non-space, the
+               previous character was the last character of a word and we update
+               the length */
+            *length = l - 1;
+        }
+        else if (!is_space && was_space) {
+            /* If this is a non-space character following a space character,
+               this is the first character of a word and we update the offset of
+               the next line */
+            result = i;
+        }
+        was_space = is_space;
+
+        /* Find the next run of ASCII characters; the line cannot take more
+           than max_length - l more of them */
+        if (i >= ascii_end) {
+            size_t size = end - i;
+
+            if (size > max_length - l + 1) {
+                size = max_length - l + 1;
+            }
+            ascii_end = i + arguments_ascii_length(s + i, size);
+        }
+
+        /* Calculate how many bytes we need to increment our position for the
+           current character */
+        di = (i < ascii_end) ? 1 : mbrlen(s + i, end - i, &mbs);
+        switch (di) {
+        case 0:
+            /* This should really not happen */
+            break;
+
+        case (size_t)-1:
+            /* Invalid character sequence; skip to the next byte */
+            i++;
+            break;
+
+        case (size_t)-2:
+            /* Possibly incomplete multi byte sequence; skip to the next
+               byte */
+            i++;
+            break;
+
+        default:
+            i += di;
+        }
+
+        /* If this is the last character of the string, we update length and
+           result to make sure that all characters are included and the caller
+           knows that the string has been terminated */
+        if (i == end) {
+            *length = l;
+            result = i;
+        }
+    }
+
+    /* If result is less than length, we have stopped before reaching a new
+       word */
+    if (result < *length) {
+        result = *length;
+    }
+
+    /* Skip any trailing space so that the next offset will be the start of a
+       word or the end of the string */
+    while ((result < end) && (s[result] == ' ')) result++;
+
+    return result;
+}
+
+/**
+ * A growing buffer into which the help is rendered.
+ *
+ *   * data: the rendered text
+ *   * length: the number of bytes in data
+ *   * size: the number of bytes allocated for data
+ *   * is_valid: whether all memory allocations have succeeded
+ */
+struct arguments_help_buffer_t {
+    char *data;
+    size_t length;
+    size_t size;
+    int is_valid;
+};
+
+/**
+ * Reserves space in a help buffer.
+ *
+ * @param buffer
+ *     The buffer.
+ * @param length
+ *     The number of bytes to append.
+ * @return a pointer to where the bytes can be written, or NULL if memory could
+ *     not be allocated
+ */
+static char *
+arguments_help_reserve(struct arguments_help_buffer_t *buffer, size_t length)
+{
+    if (!buffer->is_valid) {
+        return NULL;
+    }
+
+    if (buffer->size - buffer->length < length) {
+        size_t size = buffer->size ? 2 * buffer->size : 4096;
+        char *data;
+
+        while (size - buffer->length < length) {
+            size *= 2;
+        }
+
+        data = (char*)realloc(buffer->data, size);
+        if (!data) {
+            buffer->is_valid = 0;
+            return NULL;
+        }
+        buffer->data = data;
+        buffer->size = size;
+    }
+
+    buffer->length += length;
+
+    return buffer->data + buffer->length - length;
+}
+
+/**
+ * Appends bytes to a help buffer.
+ *
+ * @param buffer
+ *     The buffer.
+ * @param s
+ *     The bytes to append.
+ * @param length
+ *     The number of bytes to append.
+ */
+static void
+arguments_help_append(struct arguments_help_buffer_t *buffer, const char *s,
+    size_t length)
+{
+    char *target = arguments_help_reserve(buffer, length);
+
+    if (target) {
+        memcpy(target, s, length);
+    }
+}
+
+/**
+ * Appends spaces to a help buffer.
+ *
+ * @param buffer
+ *     The buffer.
+ * @param count
+ *     The number of spaces to append.
+ */
+static void
+arguments_help_pad(struct arguments_help_buffer_t *buffer, size_t count)
+{
+    char *target = arguments_help_reserve(buffer, count);
+
+    if (target) {
+        memset(target, ' ', count);
+    }
+}
+
+/**
+ * Renders the help for a single argument.
+ *
+ * @param buffer
+ *     The buffer to render into.
+ * @param header
+ *     The long name of the argument. This parameter is optional and may be
+ *     NULL if only the help should be rendered. In that case, header_width is
+ *     set to 0.
+ * @param short_name
+ *     The short name of the argument, or NULL.
+ * @param help
+ *     The help string.
+ * @param header_width
+ *     The width of the header column.
+ * @param terminal_width
+ *     The width of the terminal.
+ */
+static void
+arguments_render_help_string(struct arguments_help_buffer_t *buffer,
+    const char *header, const char *short_name, const char *help,
+    unsigned int header_width, unsigned int terminal_width)
+{
+    const char *c;
+    size_t remaining;
+    unsigned int line_width;
+
+    /* Render the header, which is the argument names left aligned and padded
+       up to header_width characters */
+    if (header) {
+        size_t length = strlen(header);
+
+        arguments_help_append(buffer, "\n", 1);
+        arguments_help_append(buffer, header, length);
+        if (short_name) {
+            size_t short_length = strlen(short_name);
+
+            arguments_help_append(buffer, ", ", 2);
+            arguments_help_append(buffer, short_name, short_length);
+            length += 2 + short_length;
+        }
+        arguments_help_pad(buffer,
+            (length < header_width ? header_width - length : 0) + 1);
+    }
+    else {
+        header_width = 0;
+    }
+
+    /* Do not wrap if the terminal leaves no room beside the header */
+    line_width = terminal_width - header_width - (header ? 1 : 0);
+    if (terminal_width < header_width + 3) {
+        line_width = (unsigned int)-1;
+    }
+
+    /* The length of the help string is only computed once */
+    c = help;
+    remaining = strlen(help);
+    while (remaining) {
+        unsigned int n, length;
+
+        /* Get the length of the current line, and the offset of the start of
+           the next line */
+        n = arguments_get_line(c, remaining, &length,
+            header ? line_width : line_width - 1);
+
+        /* Render at most length charaters from the current offset in the help
+           string */
+        arguments_help_append(buffer, c, length);
+
+        /* Do not render newline when the string covers the entire line */
+        if (length < line_width) {
+            arguments_help_append(buffer, "\n", 1);
+        }
+        c += n;
+        remaining -= n;
+
+        /* If we have not reached the end of the help string, render a new empty
+           header column; do not do this if no header has been specified */
+        if (remaining && header) {
+            arguments_help_pad(buffer, header_width + 1);
+        }
+    }
+}
@@ -0,0 +1,276 @@
+/**
+ * The size of arguments_dependencies, not counting the terminating element.
+ */
+enum {
+    ARGUMENTS_DEPENDENCY_COUNT = 0
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release)
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#undef ARGUMENT_DEPENDS
+#define ARGUMENT_DEPENDS(name, dependency) \
+    + 1
+#include "../arguments.def"
+};
+
+/**
+ * The dependencies declared with ARGUMENT_DEPENDS in arguments.def, terminated
+ * by an element with argument set to -1.
+ *
+ *   * argument: the index of the dependent argument
+ *   * dependency: the index of the argument it depends on
+ */
+static const struct {
+    int argument;
+    int dependency;
+} arguments_dependencies[ARGUMENTS_DEPENDENCY_COUNT + 1] = {
+#undef ARGUMENT_DEPENDS
+#define ARGUMENT_DEPENDS(name, dependency) \
+    {AI_##name, AI_##dependency},
+#include "../arguments.def"
+#undef ARGUMENT_DEPENDS
+#define ARGUMENT_DEPENDS(name, dependency)
+    {-1, -1}
+};
+
+/**
+ * The states of a conversion task.
+ */
+enum {
+    AT_PENDING,
+    AT_RUNNING,
+    AT_DONE
+};
+
+/**
+ * The scheduler state shared by the worker threads and the thread calling
+ * arguments_set.
+ *
+ *   * ctx: the context whose arguments are converted
+ *   * mutex, cond: protect and signal changes to the other fields
+ *   * states: the states of the argument conversions
+ *   * waiting: the number of unconverted dependencies of every argument
+ *   * remaining: the number of arguments not yet converted
+ *   * running: the number of conversions in progress
+ *   * is_valid: whether all conversions so far have succeeded
+ */
+struct arguments_pool_t {
+    struct arguments_context_t *ctx;
+    arguments_mutex_t mutex;
+    arguments_cond_t cond;
+    unsigned char states[ARGUMENTS_COUNT + 1];
+    unsigned int waiting[ARGUMENTS_COUNT + 1];
+    int remaining;
+    int running;
+    int is_valid;
+};
+
+/**
+ * Picks the next argument to convert.
+ *
+ * The mutex of the pool must be held. This function waits until an argument
+ * is ready, or until no more arguments will be converted.
+ *
+ * Arguments without the flag ARGUMENT_INDEPENDENT are only picked by the
+ * thread calling arguments_set. Among those whose dependencies have been
+ * converted, the first one defined is picked, so an argument waiting for a
+ * dependency may be converted after arguments defined later; that thread
+ * only picks independent arguments when no other argument is ready.
+ *
+ * @param pool
+ *     The scheduler state.
+ * @param is_main
+ *     Whether the caller is the thread calling arguments_set.
+ * @return the index of the argument to convert, or -1 if all arguments have
+ *     been converted or a conversion failed
+ */
+static int
+arguments_pool_next(struct arguments_pool_t *pool, int is_main)
+{
+    while (pool->is_valid && pool->remaining) {
+        int i, candidate = -1, is_ready = 0;
+
+        for (i = 0; i < ARGUMENTS_COUNT; i++) {
+            if ((pool->states[i] != AT_PENDING) || pool->waiting[i]) {
+                continue;
+            }
+
+            is_ready = 1;
+            if (!(arguments_flags[i] & ARGUMENT_INDEPENDENT)) {
+                if (is_main) {
+                    candidate = i;
+                    break;
+                }
+            }
+            else if (candidate < 0) {
+                candidate = i;
+                if (!is_main) {
+                    break;
+                }
+            }
+        }
+
+        if (candidate >= 0) {
+            pool->states[candidate] = AT_RUNNING;
+            pool->running++;
+            return candidate;
+        }
+        else if (!is_ready && !pool->running) {
+            /* Nothing is ready and nothing is running, so the dependencies
+               are circular */
+            pool->is_valid = 0;
+            arguments_cond_broadcast(&pool->cond);
+            break;
+        }
+
+        arguments_cond_wait(&pool->cond, &pool->mutex);
+    }
+
+    return -1;
+}
+
+/**
+ * Marks an argument as converted and wakes any threads waiting for it.
+ *
+ * The mutex of the pool must be held.
+ *
+ * @param pool
+ *     The scheduler state.
+ * @param index
+ *     The index of the converted argument.
+ * @param is_valid
+ *     Whether the conversion succeeded.
+ */
+static void
+arguments_pool_done(struct arguments_pool_t *pool, int index, int is_valid)
+{
+    int i;
+
+    pool->states[index] = AT_DONE;
+    pool->running--;
+    pool->remaining--;
+    pool->is_valid &= is_valid;
+
+    for (i = 0; arguments_dependencies[i].argument >= 0; i++) {
+        if (arguments_dependencies[i].dependency == index) {
+            pool->waiting[arguments_dependencies[i].argument]--;
+        }
+    }
+
+    arguments_cond_broadcast(&pool->cond);
+}
+
+/**
+ * Converts arguments until no more arguments will be converted.
+ *
+ * @param pool
+ *     The scheduler state.
+ * @param is_main
+ *     Whether the caller is the thread calling arguments_set.
+ */
+static void
+arguments_pool_run(struct arguments_pool_t *pool, int is_main)
+{
+    int index;
+
+    arguments_mutex_lock(&pool->mutex);
+    while ((index = arguments_pool_next(pool, is_main)) >= 0) {
+        int is_valid;
+
+        arguments_mutex_unlock(&pool->mutex);
+        is_valid = arguments_converters[index](pool->ctx);
+        arguments_mutex_lock(&pool->mutex);
+
+        arguments_pool_done(pool, index, is_valid);
+    }
+    arguments_mutex_unlock(&pool->mutex);
+}
+
+/**
+ * The worker thread function.
+ *
+ * @param arg
+ *     The scheduler state.
+ */
+ARGUMENTS_THREAD_FUNCTION(arguments_pool_worker, arg)
+{
+    arguments_pool_run((struct arguments_pool_t*)arg, 0);
+
+    return ARGUMENTS_THREAD_RESULT;
+}
+
+/**
+ * Converts all arguments, using up to ARGUMENTS_PARALLEL worker threads for
+ * the arguments with the flag ARGUMENT_INDEPENDENT.
+ *
+ * Dependencies declared with ARGUMENT_DEPENDS are always converted before the
+ * arguments depending on them. All worker threads have terminated when this
+ * function returns.
+ *
+ * @param ctx
+ *     The context whose arguments are converted.
+ * @return non-zero if all arguments were converted successfully, or 0 if a
+ *     value was invalid or the dependencies are circular
+ */
+static int
+arguments_parallel_convert(struct arguments_context_t *ctx)
+{
+    struct arguments_pool_t pool;
+    arguments_thread_t threads[ARGUMENTS_PARALLEL];
+    int i, independent, started;
+
+    memset(&pool, 0, sizeof(pool));
+    pool.ctx = ctx;
+    pool.is_valid = 1;
+
+    /* The arguments of commands that have not been selected, and those
+       loaded from a snapshot, are never converted, so nothing waits for
+       them */
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        if (arguments_is_visible(i, ctx->state->command)
+                && !arguments_bit_get(ctx->state->initialized, i)) {
+            pool.remaining++;
+        }
+        else {
+            pool.states[i] = AT_DONE;
+        }
+    }
+    for (i = 0; arguments_dependencies[i].argument >= 0; i++) {
+        if (pool.states[arguments_dependencies[i].dependency] != AT_DONE) {
+            pool.waiting[arguments_dependencies[i].argument]++;
+        }
+    }
+
+    arguments_mutex_init(&pool.mutex);
+    arguments_cond_init(&pool.cond);
+
+    /* Do not start more workers than there are independent arguments */
+    independent = 0;
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        if ((arguments_flags[i] & ARGUMENT_INDEPENDENT)
+                && (pool.states[i] == AT_PENDING)) {
+            independent++;
+        }
+    }
+
+    /* If a thread cannot be started, the calling thread will convert the
+       arguments it would have */
+    started = 0;
+    while ((started < ARGUMENTS_PARALLEL) && (started < independent)
+            && arguments_thread_start(&threads[started],
+                arguments_pool_worker, &pool)) {
+        started++;
+    }
+
+    arguments_pool_run(&pool, 1);
+
+    for (i = 0; i < started; i++) {
+        arguments_thread_join(threads[i]);
+    }
+
+    arguments_cond_destroy(&pool.cond);
+    arguments_mutex_destroy(&pool.mutex);
+
+    return pool.is_valid;
+}
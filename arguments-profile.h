@@ -0,0 +1,95 @@
+#if defined(WIN32)
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+/**
+ * The name of the environment variable that makes an automatic main print the
+ * profile to stderr when the process terminates.
+ */
+#ifndef ARGUMENTS_PROFILE_ENVIRONMENT
+    #define ARGUMENTS_PROFILE_ENVIRONMENT "ARGUMENTS_PROFILE"
+#endif
+
+/**
+ * The time spent in the blocks of arguments.def, in nanoseconds.
+ *
+ *   * converted: the time spent in read or set_default of every argument,
+ *     indexed by AI_name
+ *   * released: the time spent in release of every argument, indexed by
+ *     AI_name
+ *   * setup: the time spent in arguments_setup
+ *   * teardown: the time spent in arguments_teardown
+ */
+struct arguments_profile_t {
+    unsigned long long converted[ARGUMENTS_COUNT + 1];
+    unsigned long long released[ARGUMENTS_COUNT + 1];
+    unsigned long long setup;
+    unsigned long long teardown;
+};
+
+/**
+ * Returns the time of a monotonic clock.
+ *
+ * @return the number of nanoseconds since an arbitrary point in time
+ */
+static unsigned long long
+arguments_profile_now(void)
+{
+#if defined(WIN32)
+    LARGE_INTEGER counter, frequency;
+
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+
+    return (unsigned long long)(counter.QuadPart / frequency.QuadPart)
+        * 1000000000ULL
+        + (unsigned long long)(counter.QuadPart % frequency.QuadPart)
+        * 1000000000ULL / frequency.QuadPart;
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+/**
+ * Starts and stops timing a block.
+ *
+ * ARGUMENTS_PROFILE_START is a declaration and must be placed with the other
+ * declarations of a block; ARGUMENTS_PROFILE_STOP stores the time elapsed
+ * since then in target.
+ */
+#define ARGUMENTS_PROFILE_START \
+    unsigned long long arguments_profile_started = arguments_profile_now();
+#define ARGUMENTS_PROFILE_STOP(target) \
+    (target) = arguments_profile_now() - arguments_profile_started;
+
+/**
+ * Prints a profile as a single line of JSON.
+ *
+ * The times are given in nanoseconds, as
+ * {"setup":n,"teardown":n,"arguments":{"name":{"convert":n,"release":n},...}}.
+ *
+ * @param stream
+ *     The stream to print to.
+ * @param profile
+ *     The profile.
+ */
+static ARGUMENTS_UNUSED void
+arguments_profile_print(FILE *stream, const struct arguments_profile_t *profile)
+{
+    int i;
+
+    fprintf(stream, "{\"setup\":%llu,\"teardown\":%llu,\"arguments\":{",
+        profile->setup, profile->teardown);
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        fprintf(stream, "%s\"%s\":{\"convert\":%llu,\"release\":%llu}",
+            i ? "," : "", arguments_descriptors[i].name,
+            profile->converted[i], profile->released[i]);
+    }
+    fprintf(stream, "}}\n");
+}
@@ -0,0 +1,806 @@
+#include <ctype.h>
+#include <limits.h>
+#include <locale.h>
+#include <string.h>
+
+#if defined(__cplusplus) && (__cplusplus >= 201703L)
+    #include <charconv>
+    #include <system_error>
+#endif
+
+#if defined(__SSE2__) && defined(__GNUC__)
+    #include <emmintrin.h>
+#endif
+
+/**
+ * Casts an allocated pointer to the type of another pointer, which is required
+ * in C++.
+ *
+ * @param pointer
+ *     The pointer that will receive the result.
+ */
+#if defined(__cplusplus)
+    #define ARGUMENTS_CAST(pointer) (decltype(pointer))
+#else
+    #define ARGUMENTS_CAST(pointer)
+#endif
+
+/**
+ * These are the ready-made readers that may be passed as read to the ARGUMENT
+ * macro. They require value_count to be 1, and they set is_valid to 0 unless
+ * the entire value could be parsed and fits in the target type.
+ *
+ * All parsers are independent of the current locale.
+ */
+
+/**
+ * The checks that may be passed as is_stored to ARGUMENTS_READ_VALUE and
+ * ARGUMENTS_READ_LIST.
+ *
+ * @param stored
+ *     The value stored in the target.
+ * @param value
+ *     The parsed value.
+ */
+#define ARGUMENTS_IS_EXACT(stored, value) ((stored) == (value))
+#define ARGUMENTS_IS_ANY(stored, value) 1
+
+/**
+ * Reads a single value with a parser.
+ *
+ * @param value_type
+ *     The type of the value produced by parse.
+ * @param parse
+ *     The parser, called as parse(s, end, &value).
+ * @param is_stored
+ *     ARGUMENTS_IS_EXACT to require the value to be unchanged when stored in
+ *     the target, or ARGUMENTS_IS_ANY otherwise.
+ */
+#define ARGUMENTS_READ_VALUE(value_type, parse, is_stored) \
+    do { \
+        const char *arguments_s = value_strings[0]; \
+        value_type arguments_value; \
+        \
+        is_valid = parse(arguments_s, arguments_s + strlen(arguments_s), \
+            &arguments_value); \
+        if (is_valid) { \
+            *target = arguments_value; \
+            is_valid = is_stored(*target, arguments_value); \
+        } \
+    } while (0);
+
+/**
+ * Reads a comma separated list of values with a parser.
+ *
+ * The values are counted first, so the list is allocated once from the arena.
+ * If any value is invalid, the list is left empty.
+ *
+ * @param value_type
+ *     The type of the value produced by parse.
+ * @param parse
+ *     The parser, called as parse(s, end, &value) for every value.
+ * @param is_stored
+ *     ARGUMENTS_IS_EXACT to require every value to be unchanged when stored in
+ *     the list, or ARGUMENTS_IS_ANY otherwise.
+ */
+#define ARGUMENTS_READ_LIST(value_type, parse, is_stored) \
+    do { \
+        const char *arguments_s = value_strings[0]; \
+        const char *arguments_end = arguments_s + strlen(arguments_s); \
+        size_t arguments_i; \
+        \
+        target->length = arguments_list_count(arguments_s, arguments_end); \
+        target->values = ARGUMENTS_CAST(target->values) \
+            arguments_arena_allocate(arena, \
+                (target->length + 1) * sizeof(*target->values)); \
+        is_valid = (target->values != NULL); \
+        \
+        for (arguments_i = 0; is_valid && (arguments_i < target->length); \
+                arguments_i++) { \
+            const char *arguments_next = (const char*)memchr(arguments_s, \
+                ',', arguments_end - arguments_s); \
+            value_type arguments_value; \
+            \
+            if (!arguments_next) { \
+                arguments_next = arguments_end; \
+            } \
+            is_valid = parse(arguments_s, arguments_next, &arguments_value); \
+            if (is_valid) { \
+                target->values[arguments_i] = arguments_value; \
+                is_valid = is_stored(target->values[arguments_i], \
+                    arguments_value); \
+            } \
+            arguments_s = arguments_next + 1; \
+        } \
+        \
+        if (!is_valid) { \
+            target->values = NULL; \
+            target->length = 0; \
+        } \
+    } while (0);
+
+/**
+ * Reads a signed integer into an integer of any signed type.
+ *
+ * The value is a decimal number, or a hexadecimal number prefixed by "0x",
+ * optionally preceded by a sign.
+ */
+#define ARGUMENT_READ_INT \
+    ARGUMENTS_READ_VALUE(long long, arguments_parse_integer, \
+        ARGUMENTS_IS_EXACT)
+
+/**
+ * Reads an unsigned integer into an integer of any unsigned type.
+ *
+ * The value is a decimal number, or a hexadecimal number prefixed by "0x".
+ */
+#define ARGUMENT_READ_UNSIGNED \
+    ARGUMENTS_READ_VALUE(unsigned long long, arguments_parse_unsigned, \
+        ARGUMENTS_IS_EXACT)
+
+/**
+ * Reads a floating point number into a float or a double.
+ *
+ * The value is a decimal number with an optional fraction and exponent, and
+ * "." is always the decimal point.
+ */
+#define ARGUMENT_READ_DOUBLE \
+    ARGUMENTS_READ_VALUE(double, arguments_parse_double, \
+        ARGUMENTS_IS_ANY)
+
+/**
+ * Reads a byte size into an integer of any unsigned type.
+ *
+ * The value is an unsigned integer optionally followed by one of the suffixes
+ * K, M, G, T, P or E, which multiply it by a power of 1024. The suffix may be
+ * followed by "B" or "iB", and is not case sensitive.
+ */
+#define ARGUMENT_READ_SIZE \
+    ARGUMENTS_READ_VALUE(unsigned long long, arguments_parse_size, \
+        ARGUMENTS_IS_EXACT)
+
+/**
+ * Reads a duration into an integer of any unsigned type.
+ *
+ * The value is a decimal number with an optional fraction, optionally
+ * followed by one of the units ns, us, ms, s, m, h or d. A value without a
+ * unit is in the unit given.
+ *
+ * @param unit
+ *     The unit of the target value; one of ARGUMENT_NANOSECONDS,
+ *     ARGUMENT_MICROSECONDS, ARGUMENT_MILLISECONDS and ARGUMENT_SECONDS.
+ */
+#define ARGUMENT_READ_DURATION(unit) \
+    do { \
+        const char *arguments_s = value_strings[0]; \
+        unsigned long long arguments_value; \
+        \
+        is_valid = arguments_parse_duration(arguments_s, \
+            arguments_s + strlen(arguments_s), (unit), &arguments_value); \
+        if (is_valid) { \
+            *target = arguments_value; \
+            is_valid = (*target == arguments_value); \
+        } \
+    } while (0);
+
+/**
+ * The units that may be passed to ARGUMENT_READ_DURATION, in nanoseconds.
+ */
+#define ARGUMENT_NANOSECONDS 1ULL
+#define ARGUMENT_MICROSECONDS 1000ULL
+#define ARGUMENT_MILLISECONDS 1000000ULL
+#define ARGUMENT_SECONDS 1000000000ULL
+
+/**
+ * Reads a boolean into an integer of any type.
+ *
+ * The values "1", "yes", "true" and "on" are read as 1 and the values "0",
+ * "no", "false" and "off" as 0. They are not case sensitive.
+ */
+#define ARGUMENT_READ_BOOL \
+    ARGUMENTS_READ_VALUE(int, arguments_parse_bool, \
+        ARGUMENTS_IS_ANY)
+
+/**
+ * Reads a comma separated list of signed integers into an argument of type
+ * ARGUMENT_LIST(type), where type is any signed integer type.
+ *
+ * Release the list with ARGUMENT_RELEASE_LIST.
+ */
+#define ARGUMENT_READ_INT_LIST \
+    ARGUMENTS_READ_LIST(long long, arguments_parse_integer, \
+        ARGUMENTS_IS_EXACT)
+
+/**
+ * Reads a comma separated list of unsigned integers into an argument of type
+ * ARGUMENT_LIST(type), where type is any unsigned integer type.
+ *
+ * Release the list with ARGUMENT_RELEASE_LIST.
+ */
+#define ARGUMENT_READ_UNSIGNED_LIST \
+    ARGUMENTS_READ_LIST(unsigned long long, arguments_parse_unsigned, \
+        ARGUMENTS_IS_EXACT)
+
+/**
+ * Reads a comma separated list of floating point numbers into an argument of
+ * type ARGUMENT_LIST(float) or ARGUMENT_LIST(double).
+ *
+ * Release the list with ARGUMENT_RELEASE_LIST.
+ */
+#define ARGUMENT_READ_DOUBLE_LIST \
+    ARGUMENTS_READ_LIST(double, arguments_parse_double, \
+        ARGUMENTS_IS_ANY)
+
+/**
+ * Reads a comma separated list of unsigned integers and intervals on the form
+ * first-last, such as "0-63,128", into an argument of type
+ * ARGUMENT_LIST(struct arguments_interval_t). A single integer is read as an
+ * interval where first and last are equal.
+ *
+ * Release the list with ARGUMENT_RELEASE_LIST.
+ */
+#define ARGUMENT_READ_RANGE_LIST \
+    ARGUMENTS_READ_LIST(struct arguments_interval_t, \
+        arguments_parse_interval, ARGUMENTS_IS_ANY)
+
+/**
+ * Releases a list read by one of the list readers.
+ *
+ * Lists are allocated from the arena, so this does nothing.
+ */
+#define ARGUMENT_RELEASE_LIST
+
+
+/**
+ * Parses the digits of an unsigned integer.
+ *
+ * @param s
+ *     The string to parse. Upon return, this will point to the first character
+ *     that was not parsed.
+ * @param end
+ *     The end of the string.
+ * @param result
+ *     The parsed value.
+ * @return non-zero if at least one digit was parsed and the value did not
+ *     overflow, or 0 otherwise
+ */
+static ARGUMENTS_UNUSED int
+arguments_parse_digits(const char **s, const char *end,
+    unsigned long long *result)
+{
+    const char *c = *s;
+    int base = 10;
+    int ok = 1;
+
+    if ((end - c >= 2) && (c[0] == '0') && ((c[1] == 'x') || (c[1] == 'X'))) {
+        base = 16;
+        c += 2;
+    }
+
+    *result = 0;
+    for (*s = c; c < end; c++) {
+        unsigned int digit;
+
+        if ((*c >= '0') && (*c <= '9')) {
+            digit = *c - '0';
+        }
+        else if ((base == 16) && (*c >= 'a') && (*c <= 'f')) {
+            digit = *c - 'a' + 10;
+        }
+        else if ((base == 16) && (*c >= 'A') && (*c <= 'F')) {
+            digit = *c - 'A' + 10;
+        }
+        else {
+            break;
+        }
+
+        if (*result > (ULLONG_MAX - digit) / base) {
+            ok = 0;
+        }
+        *result = *result * base + digit;
+    }
+
+    ok &= (c != *s);
+    *s = c;
+
+    return ok;
+}
+
+/**
+ * Parses an unsigned integer that is not preceded by a sign.
+ *
+ * @param s, end
+ *     The string to parse.
+ * @param result
+ *     The parsed value.
+ * @return non-zero if the entire string is a valid unsigned integer, or 0
+ *     otherwise
+ */
+static ARGUMENTS_UNUSED int
+arguments_parse_magnitude(const char *s, const char *end,
+    unsigned long long *result)
+{
+#if defined(__cplusplus) && (__cplusplus >= 201703L)
+    int base = 10;
+    std::from_chars_result r;
+
+    if ((end - s >= 2) && (s[0] == '0') && ((s[1] == 'x') || (s[1] == 'X'))) {
+        base = 16;
+        s += 2;
+    }
+    if ((s == end) || (*s == '-') || (*s == '+')) {
+        return 0;
+    }
+
+    r = std::from_chars(s, end, *result, base);
+
+    return (r.ec == std::errc()) && (r.ptr == end);
+#else
+    return arguments_parse_digits(&s, end, result) && (s == end);
+#endif
+}
+
+/**
+ * Parses a signed integer.
+ *
+ * @param s, end
+ *     The string to parse.
+ * @param result
+ *     The parsed value.
+ * @return non-zero if the entire string is a valid integer, or 0 otherwise
+ */
+static ARGUMENTS_UNUSED int
+arguments_parse_integer(const char *s, const char *end, long long *result)
+{
+    int is_negative = (s < end) && (*s == '-');
+    unsigned long long magnitude;
+
+    if ((s < end) && ((*s == '-') || (*s == '+'))) {
+        s++;
+    }
+    if (!arguments_parse_magnitude(s, end, &magnitude)) {
+        return 0;
+    }
+
+    if (is_negative) {
+        if (magnitude > (unsigned long long)LLONG_MAX + 1) {
+            return 0;
+        }
+        *result = (long long)(0 - magnitude);
+    }
+    else {
+        if (magnitude > (unsigned long long)LLONG_MAX) {
+            return 0;
+        }
+        *result = (long long)magnitude;
+    }
+
+    return 1;
+}
+
+/**
+ * Parses an unsigned integer.
+ *
+ * @param s, end
+ *     The string to parse.
+ * @param result
+ *     The parsed value.
+ * @return non-zero if the entire string is a valid unsigned integer, or 0
+ *     otherwise
+ */
+static ARGUMENTS_UNUSED int
+arguments_parse_unsigned(const char *s, const char *end,
+    unsigned long long *result)
+{
+    if ((s < end) && (*s == '+')) {
+        s++;
+    }
+
+    return arguments_parse_magnitude(s, end, result);
+}
+
+/**
+ * Parses a floating point number with strtod.
+ *
+ * The string is copied if it is not terminated at end, or if the decimal point
+ * of the current locale is not ".", in which case it is replaced. Leading
+ * white space, which strtod would skip, is rejected like in the integer
+ * parsers.
+ *
+ * @param s, end
+ *     The string to parse.
+ * @param result
+ *     The parsed value.
+ * @return non-zero if the entire string is a valid floating point number, or
+ *     0 otherwise
+ */
+static ARGUMENTS_UNUSED int
+arguments_parse_double_strtod(const char *s, const char *end, double *result)
+{
+    const char *point = localeconv()->decimal_point;
+    const char *dot = (const char*)memchr(s, '.', end - s);
+    size_t point_length = strlen(point);
+    char *copy, *copy_end;
+    int ok;
+
+    if ((s == end) || isspace((unsigned char)*s)) {
+        return 0;
+    }
+    if (!*end && (!dot || (strcmp(point, ".") == 0))) {
+        *result = strtod(s, &copy_end);
+        return (s != end) && (copy_end == end);
+    }
+
+    copy = (char*)malloc((end - s) + point_length + 1);
+    if (!copy) {
+        return 0;
+    }
+    if (dot) {
+        memcpy(copy, s, dot - s);
+        memcpy(copy + (dot - s), point, point_length);
+        memcpy(copy + (dot - s) + point_length, dot + 1, end - dot - 1);
+        copy[(end - s) - 1 + point_length] = '\0';
+    }
+    else {
+        memcpy(copy, s, end - s);
+        copy[end - s] = '\0';
+    }
+
+    *result = strtod(copy, &copy_end);
+    ok = (copy_end != copy) && !*copy_end;
+    free(copy);
+
+    return ok;
+}
+
+/**
+ * Parses a floating point number.
+ *
+ * Numbers with at most 19 significant digits and a small exponent are
+ * converted exactly without calling strtod.
+ *
+ * @param s, end
+ *     The string to parse.
+ * @param result
+ *     The parsed value.
+ * @return non-zero if the entire string is a valid floating point number, or
+ *     0 otherwise
+ */
+static ARGUMENTS_UNUSED int
+arguments_parse_double(const char *s, const char *end, double *result)
+{
+#if defined(__cplusplus) && defined(__cpp_lib_to_chars)
+    std::from_chars_result r;
+
+    if ((s < end) && (*s == '+')) {
+        s++;
+        if ((s < end) && ((*s == '-') || (*s == '+'))) {
+            return 0;
+        }
+    }
+
+    r = std::from_chars(s, end, *result);
+
+    return (s != end) && (r.ec == std::errc()) && (r.ptr == end);
+#else
+    static const double powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char *c = s;
+    unsigned long long mantissa = 0;
+    int digits = 0, exponent = 0, is_negative = 0, is_exact = 1;
+    int seen_digit = 0, seen_point = 0;
+
+    if ((c < end) && ((*c == '-') || (*c == '+'))) {
+        is_negative = (*c == '-');
+        c++;
+    }
+
+    /* Collect the significant digits and the decimal exponent */
+    for (; c < end; c++) {
+        if ((*c == '.') && !seen_point) {
+            seen_point = 1;
+            continue;
+        }
+        else if ((*c < '0') || (*c > '9')) {
+            break;
+        }
+
+        seen_digit = 1;
+        if (mantissa || (*c != '0')) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*c - '0');
+                digits++;
+                exponent -= seen_point;
+            }
+            else {
+                is_exact = 0;
+                exponent += !seen_point;
+            }
+        }
+        else {
+            exponent -= seen_point;
+        }
+    }
+    if (!seen_digit) {
+        /* This may be inf or nan, which strtod handles */
+        return arguments_parse_double_strtod(s, end, result);
+    }
+    if ((c < end) && ((*c == 'e') || (*c == 'E'))) {
+        int exponent_sign = 1, value = 0;
+
+        c++;
+        if ((c < end) && ((*c == '-') || (*c == '+'))) {
+            exponent_sign = (*c == '-') ? -1 : 1;
+            c++;
+        }
+        if ((c == end) || (*c < '0') || (*c > '9')) {
+            return 0;
+        }
+        for (; (c < end) && (*c >= '0') && (*c <= '9'); c++) {
+            if (value < 100000) {
+                value = value * 10 + (*c - '0');
+            }
+        }
+        exponent += exponent_sign * value;
+    }
+    if (c != end) {
+        return 0;
+    }
+
+    /* If the mantissa and the power of ten are both exactly representable,
+       a single multiplication or division is correctly rounded */
+    if (is_exact && (mantissa <= (1ULL << 53))
+            && (exponent >= -22) && (exponent <= 22)) {
+        *result = exponent < 0
+            ? (double)mantissa / powers[-exponent]
+            : (double)mantissa * powers[exponent];
+        if (is_negative) {
+            *result = -*result;
+        }
+        return 1;
+    }
+
+    return arguments_parse_double_strtod(s, end, result);
+#endif
+}
+
+/**
+ * Parses a byte size.
+ *
+ * @param s, end
+ *     The string to parse.
+ * @param result
+ *     The parsed value, in bytes.
+ * @return non-zero if the entire string is a valid size that does not
+ *     overflow, or 0 otherwise
+ */
+static ARGUMENTS_UNUSED int
+arguments_parse_size(const char *s, const char *end,
+    unsigned long long *result)
+{
+    static const char suffixes[] = "KMGTPE";
+    const char *suffix;
+    unsigned int shift = 0;
+
+    if (!arguments_parse_digits(&s, end, result)) {
+        return 0;
+    }
+
+    if ((s < end) && *s
+            && (suffix = strchr(suffixes, toupper((unsigned char)*s)))) {
+        shift = 10 * (suffix - suffixes + 1);
+        s++;
+        if ((end - s >= 2) && ((s[0] == 'i') || (s[0] == 'I'))
+                && ((s[1] == 'b') || (s[1] == 'B'))) {
+            s++;
+        }
+    }
+    if ((s < end) && ((*s == 'b') || (*s == 'B'))) {
+        s++;
+    }
+    if ((s != end) || (shift && (*result > (ULLONG_MAX >> shift)))) {
+        return 0;
+    }
+
+    *result <<= shift;
+
+    return 1;
+}
+
+/**
+ * Parses a duration.
+ *
+ * @param s, end
+ *     The string to parse.
+ * @param unit
+ *     The unit of the result, and of the string if it has no unit, in
+ *     nanoseconds.
+ * @param result
+ *     The parsed value, in unit.
+ * @return non-zero if the entire string is a valid duration that does not
+ *     overflow, or 0 otherwise
+ */
+static ARGUMENTS_UNUSED int
+arguments_parse_duration(const char *s, const char *end,
+    unsigned long long unit, unsigned long long *result)
+{
+    static const struct {
+        const char *name;
+        unsigned long long nanoseconds;
+    } units[] = {
+        {"ns", 1ULL},
+        {"us", 1000ULL},
+        {"ms", 1000000ULL},
+        {"s", 1000000000ULL},
+        {"m", 60000000000ULL},
+        {"h", 3600000000000ULL},
+        {"d", 86400000000000ULL},
+        {NULL, 0}};
+    unsigned long long whole, fraction = 0, scale = 1, nanoseconds = unit;
+    int i;
+
+    if (!arguments_parse_digits(&s, end, &whole)) {
+        return 0;
+    }
+    if ((s < end) && (*s == '.')) {
+        for (s++; (s < end) && (*s >= '0') && (*s <= '9'); s++) {
+            /* Digits beyond the ninth are ignored, which also prevents the
+               conversion below from overflowing */
+            if (scale < 1000000000ULL) {
+                fraction = fraction * 10 + (*s - '0');
+                scale *= 10;
+            }
+        }
+    }
+    if (s != end) {
+        for (i = 0; units[i].name; i++) {
+            if ((strlen(units[i].name) == (size_t)(end - s))
+                    && (memcmp(s, units[i].name, end - s) == 0)) {
+                nanoseconds = units[i].nanoseconds;
+                break;
+            }
+        }
+        if (!units[i].name) {
+            return 0;
+        }
+    }
+
+    /* Convert to nanoseconds, and then to the requested unit */
+    if (whole > ULLONG_MAX / nanoseconds) {
+        return 0;
+    }
+    whole *= nanoseconds;
+    if (fraction) {
+        /* Split the multiplication to avoid overflowing */
+        unsigned long long extra = fraction * (nanoseconds / scale)
+            + fraction * (nanoseconds % scale) / scale;
+
+        if (whole > ULLONG_MAX - extra) {
+            return 0;
+        }
+        whole += extra;
+    }
+
+    *result = whole / unit;
+
+    return 1;
+}
+
+/**
+ * Parses a boolean.
+ *
+ * @param s, end
+ *     The string to parse.
+ * @param result
+ *     The parsed value; 1 or 0.
+ * @return non-zero if the string is a valid boolean, or 0 otherwise
+ */
+static ARGUMENTS_UNUSED int
+arguments_parse_bool(const char *s, const char *end, int *result)
+{
+    static const char *const values[] = {
+        "0", "no", "false", "off",
+        "1", "yes", "true", "on",
+        NULL};
+    int i;
+
+    for (i = 0; values[i]; i++) {
+        const char *a = s, *b = values[i];
+
+        while ((a < end) && (tolower((unsigned char)*a) == *b)) {
+            a++;
+            b++;
+        }
+        if ((a == end) && !*b) {
+            *result = (i >= 4);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Parses an unsigned integer or an interval on the form first-last.
+ *
+ * @param s, end
+ *     The string to parse.
+ * @param result
+ *     The parsed interval.
+ * @return non-zero if the entire string is a valid interval where first is
+ *     not greater than last, or 0 otherwise
+ */
+static ARGUMENTS_UNUSED int
+arguments_parse_interval(const char *s, const char *end,
+    struct arguments_interval_t *result)
+{
+    const char *dash = (const char*)memchr(s, '-', end - s);
+
+    if (!dash) {
+        if (!arguments_parse_magnitude(s, end, &result->first)) {
+            return 0;
+        }
+        result->last = result->first;
+        return 1;
+    }
+
+    return arguments_parse_magnitude(s, dash, &result->first)
+        && arguments_parse_magnitude(dash + 1, end, &result->last)
+        && (result->first <= result->last);
+}
+
+/**
+ * Counts the comma separated values of a list.
+ *
+ * The commas are counted 16 bytes at a time with SSE2 when available, and
+ * otherwise 8 bytes at a time in a 64 bit integer.
+ *
+ * @param s, end
+ *     The list.
+ * @return the number of values; 0 if the list is empty
+ */
+static ARGUMENTS_UNUSED size_t
+arguments_list_count(const char *s, const char *end)
+{
+    size_t result = 1;
+
+    if (s == end) {
+        return 0;
+    }
+
+#if defined(__SSE2__) && defined(__GNUC__)
+    {
+        const __m128i commas = _mm_set1_epi8(',');
+
+        for (; end - s >= 16; s += 16) {
+            __m128i block = _mm_loadu_si128((const __m128i*)s);
+
+            result += __builtin_popcount(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(block, commas)));
+        }
+    }
+#else
+    {
+        const unsigned long long ones = 0x0101010101010101ULL;
+        const unsigned long long low = 0x7f7f7f7f7f7f7f7fULL;
+
+        for (; end - s >= 8; s += 8) {
+            unsigned long long block, matches;
+
+            /* Set the high bit of every byte that is a comma, and then sum
+               these bits */
+            memcpy(&block, s, sizeof(block));
+            block ^= ones * ',';
+            matches = ~(((block & low) + low) | block | low);
+            result += ((matches >> 7) * ones) >> 56;
+        }
+    }
+#endif
+
+    for (; s < end; s++) {
+        result += (*s == ',');
+    }
+
+    return result;
+}
@@ -0,0 +1,324 @@
+#if !defined(WIN32)
+    #include <signal.h>
+#endif
+
+/**
+ * The signal upon which the arguments are reloaded by a thread started by
+ * arguments_reload_start, or 0 to only reload them when arguments_reload is
+ * called. Signals are not used on Windows.
+ */
+#ifndef ARGUMENTS_RELOAD_SIGNAL
+    #if defined(WIN32)
+        #define ARGUMENTS_RELOAD_SIGNAL 0
+    #else
+        #define ARGUMENTS_RELOAD_SIGNAL SIGHUP
+    #endif
+#endif
+
+/**
+ * The values published to read sections.
+ *
+ *   * current: the context holding the latest values; initially the global
+ *     context
+ *   * phase: the element of readers incremented by new read sections
+ *   * readers: the number of read sections begun in each phase and not yet
+ *     ended
+ *   * is_reloading: whether a thread is reloading the arguments
+ *   * argc, argv: the command line parsed by every reload
+ */
+struct arguments_reload_t {
+    struct arguments_context_t *current;
+    int phase;
+    int readers[2];
+    int is_reloading;
+    int argc;
+    char **argv;
+};
+
+static struct arguments_reload_t arguments_published = {
+    &arguments_context, 0, {0, 0}, 0, 0, NULL
+};
+
+/**
+ * Begins a read section.
+ *
+ * @param phase
+ *     Receives the phase to pass to arguments_read_leave.
+ * @return the context holding the latest values
+ */
+static ARGUMENTS_UNUSED struct arguments_context_t *
+arguments_read_enter(int *phase)
+{
+    *phase = arguments_atomic_load(&arguments_published.phase);
+    arguments_atomic_add(&arguments_published.readers[*phase], 1);
+
+    /* The context is read after the section has been counted, so a reload
+       publishing a new context sees the section or the section sees the new
+       context */
+    return (struct arguments_context_t*)arguments_atomic_load_pointer(
+        &arguments_published.current);
+}
+
+/**
+ * Ends a read section.
+ *
+ * @param phase
+ *     The phase returned by arguments_read_enter.
+ */
+#define arguments_read_leave(phase) \
+    arguments_atomic_add(&arguments_published.readers[(phase)], -1)
+
+/**
+ * Begins a read section, in which ARGUMENT_VALUE, ARGUMENT_IS_PRESENT,
+ * ARGUMENT_SOURCE and ARGUMENT_SELECTED_COMMAND refer to the latest values
+ * published by arguments_reload rather than to the global variables.
+ *
+ * The values remain valid until the matching ARGUMENTS_READ_END, even if
+ * newer values are published in the meantime. Beginning and ending a section
+ * never waits, but a reload waits for all sections that may refer to the
+ * previous values to end before releasing them, so sections should be short.
+ * The section is a block that must be left through ARGUMENTS_READ_END, not
+ * with return, break or goto, and arguments_reload must not be called in it.
+ */
+#define ARGUMENTS_READ_BEGIN \
+    { \
+        int arguments_phase; \
+        struct arguments_context_t *arguments_reloaded = \
+            arguments_read_enter(&arguments_phase); \
+        struct arguments_t *arguments_current = arguments_reloaded->values; \
+        struct arguments_state_t *arguments_current_state = \
+            arguments_reloaded->state;
+
+/**
+ * Ends a read section begun with ARGUMENTS_READ_BEGIN.
+ */
+#define ARGUMENTS_READ_END \
+        if (arguments_current); \
+        if (arguments_current_state); \
+        arguments_read_leave(arguments_phase); \
+    }
+
+/**
+ * Waits before checking a condition again, first yielding the processor and
+ * then sleeping.
+ *
+ * @param spins
+ *     The number of times the condition has been checked.
+ */
+static void
+arguments_reload_wait(int spins)
+{
+    if (spins < 64) {
+        arguments_thread_yield();
+    }
+    else {
+        arguments_thread_sleep();
+    }
+}
+
+/**
+ * Waits until all read sections that may refer to the previously published
+ * context have ended.
+ *
+ * New sections are counted in the other phase while the sections of the
+ * current phase are drained. This is done twice, since a section may have
+ * read the phase before the previous change and been counted after it.
+ */
+static void
+arguments_reload_synchronize(void)
+{
+    int i, spins;
+
+    for (i = 0; i < 2; i++) {
+        int phase = arguments_published.phase;
+
+        arguments_atomic_store(&arguments_published.phase, !phase);
+
+        /* Adding 0 reads the counter in order with publishing the context */
+        for (spins = 0;
+                arguments_atomic_add(&arguments_published.readers[phase], 0);
+                spins++) {
+            arguments_reload_wait(spins);
+        }
+    }
+}
+
+/**
+ * Starts a reload, waiting for any other reload to complete first.
+ */
+static void
+arguments_reload_lock(void)
+{
+    int spins;
+
+    for (spins = 0;
+            !arguments_atomic_cas(&arguments_published.is_reloading, 0, 1);
+            spins++) {
+        arguments_reload_wait(spins);
+    }
+}
+
+/**
+ * Parses the command line passed to arguments_reload_start again, and
+ * publishes the values to read sections.
+ *
+ * The environment and the configuration file are read again, and all values
+ * are converted into a new context. Once it has been published, the previous
+ * values are released as soon as no read section refers to them. The values
+ * of the global variables, which were passed to run, are never replaced.
+ *
+ * Only one reload is performed at a time; a concurrent call waits for the
+ * other one to complete. This function must not be called in a signal handler
+ * or in a read section.
+ *
+ * @return AC_OK if the values were published, or AC_ERROR if the command
+ *     line is no longer valid, for example because a required argument is no
+ *     longer found in the environment, or if memory could not be allocated;
+ *     the previous values then remain published
+ */
+static ARGUMENTS_UNUSED int
+arguments_reload(void)
+{
+    struct arguments_context_t *ctx, *previous;
+    int result = AC_ERROR;
+
+    arguments_reload_lock();
+
+    ctx = arguments_published.argv ? arguments_create_ctx() : NULL;
+    if (ctx) {
+        ctx->config_path = arguments_context.config_path;
+        result = arguments_parse_ctx(ctx, arguments_published.argc,
+            arguments_published.argv);
+    }
+
+    if (result == AC_OK) {
+        previous = arguments_published.current;
+        arguments_atomic_store_pointer(&arguments_published.current, ctx);
+        arguments_reload_synchronize();
+        if (previous != &arguments_context) {
+            arguments_release_ctx(previous);
+        }
+    }
+    else if (ctx) {
+        arguments_release_ctx(ctx);
+    }
+
+    arguments_atomic_store(&arguments_published.is_reloading, 0);
+
+    return (result == AC_OK) ? AC_OK : AC_ERROR;
+}
+
+/**
+ * Releases the latest values published by arguments_reload when the process
+ * terminates.
+ *
+ * A reload in progress is completed first, and no other reload is started
+ * afterwards. Like a reload, this waits for all read sections that may refer
+ * to the latest values to end before releasing them. Sections begun later
+ * refer to the global variables, which are released by arguments_release.
+ */
+static void
+arguments_reload_release(void)
+{
+    struct arguments_context_t *ctx;
+
+    arguments_reload_lock();
+
+    ctx = arguments_published.current;
+    arguments_atomic_store_pointer(&arguments_published.current,
+        &arguments_context);
+    if (ctx != &arguments_context) {
+        /* Other threads may still be in read sections referring to ctx */
+        arguments_reload_synchronize();
+        arguments_release_ctx(ctx);
+    }
+}
+
+#if ARGUMENTS_RELOAD_SIGNAL && !defined(WIN32)
+/**
+ * Reloads the arguments whenever ARGUMENTS_RELOAD_SIGNAL is received.
+ */
+ARGUMENTS_THREAD_FUNCTION(arguments_reload_thread, arg)
+{
+    sigset_t signals;
+    int received;
+
+    (void)arg;
+    sigemptyset(&signals);
+    sigaddset(&signals, ARGUMENTS_RELOAD_SIGNAL);
+
+    for (;;) {
+        if (sigwait(&signals, &received) == 0) {
+            arguments_reload();
+        }
+    }
+
+    return ARGUMENTS_THREAD_RESULT;
+}
+#endif
+
+/**
+ * Blocks ARGUMENTS_RELOAD_SIGNAL in the calling thread, and thereby in all
+ * threads it starts afterwards, so that the signal is only received by the
+ * thread started by arguments_reload_start instead of terminating the
+ * process.
+ *
+ * Call this function before starting any thread, including the workers
+ * started by arguments_set if ARGUMENTS_PARALLEL is non-zero; the automatic
+ * main calls it before arguments_setup.
+ *
+ * @return AC_OK, or AC_ERROR if the signal could not be blocked
+ */
+static ARGUMENTS_UNUSED int
+arguments_reload_block(void)
+{
+#if ARGUMENTS_RELOAD_SIGNAL && !defined(WIN32)
+    sigset_t signals;
+
+    sigemptyset(&signals);
+    sigaddset(&signals, ARGUMENTS_RELOAD_SIGNAL);
+    if (pthread_sigmask(SIG_BLOCK, &signals, NULL) != 0) {
+        return AC_ERROR;
+    }
+#endif
+
+    return AC_OK;
+}
+
+/**
+ * Records the command line parsed by arguments_reload, and registers the
+ * latest values to be released when the process terminates.
+ *
+ * If ARGUMENTS_RELOAD_SIGNAL is non-zero, a thread is started that calls
+ * arguments_reload whenever the signal is received. The signal must have been
+ * blocked with arguments_reload_block before any other thread was started;
+ * it is blocked again in the calling thread. Call this function once, after
+ * arguments_set; the automatic main calls it before run.
+ *
+ * @param argc, argv
+ *     The command line passed to arguments_scan, which must remain valid until
+ *     the process terminates.
+ * @return AC_OK, or AC_ERROR if the thread could not be started
+ */
+static ARGUMENTS_UNUSED int
+arguments_reload_start(int argc, char *argv[])
+{
+    arguments_published.argc = argc;
+    arguments_published.argv = argv;
+    atexit(arguments_reload_release);
+
+#if ARGUMENTS_RELOAD_SIGNAL && !defined(WIN32)
+    {
+        arguments_thread_t thread;
+
+        if ((arguments_reload_block() != AC_OK)
+                || !arguments_thread_start(&thread, arguments_reload_thread,
+                    NULL)) {
+            return AC_ERROR;
+        }
+        pthread_detach(thread);
+    }
+#endif
+
+    return AC_OK;
+}
@@ -0,0 +1,321 @@
+#include <ctype.h>
+
+#if defined(WIN32)
+    #include <stdio.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+
+    #if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+        #define MAP_ANONYMOUS MAP_ANON
+    #endif
+#endif
+
+/**
+ * A response file read by arguments_response_expand.
+ *
+ *   * data: the contents of the file, followed by a NUL character; this is
+ *     NULL if the file could not be read
+ *   * size: the size of the file
+ */
+struct arguments_response_t {
+    char *data;
+    size_t size;
+};
+
+/**
+ * The response files expanded on the command line of a context.
+ *
+ *   * files: the response files, in the order they appear on the command line
+ *   * length: the number of elements in files
+ *   * argc, argv: the expanded command line, or 0 and NULL if no response
+ *     file was expanded
+ */
+struct arguments_responses_t {
+    struct arguments_response_t *files;
+    unsigned int length;
+    int argc;
+    char **argv;
+};
+
+/**
+ * Maps a response file into memory.
+ *
+ * The file is mapped privately, so it may be modified in memory without
+ * affecting the file. A NUL character always follows the last byte of the
+ * file.
+ *
+ * @param path
+ *     The path of the file.
+ * @param size
+ *     The size of the file is written to this variable.
+ * @return the contents of the file, or NULL if it could not be read
+ */
+static char *
+arguments_response_map(const char *path, size_t *size)
+{
+#if defined(WIN32)
+    FILE *file = fopen(path, "rb");
+    char *result = NULL;
+    long length;
+
+    if (!file) {
+        return NULL;
+    }
+
+    if ((fseek(file, 0, SEEK_END) == 0) && ((length = ftell(file)) >= 0)
+            && (fseek(file, 0, SEEK_SET) == 0)) {
+        result = (char*)malloc(length + 1);
+        if (result && (fread(result, 1, length, file) == (size_t)length)) {
+            result[length] = '\0';
+            *size = length;
+        }
+        else {
+            free(result);
+            result = NULL;
+        }
+    }
+
+    fclose(file);
+
+    return result;
+#else
+    struct stat st;
+    char *result;
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    /* Reserve one byte more than the file size as anonymous memory and then
+       map the file over it, so that the terminating NUL character never falls
+       outside of a mapped page */
+    result = (char*)mmap(NULL, st.st_size + 1, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (result == (char*)MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+    if (st.st_size && (mmap(result, st.st_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)) {
+        munmap(result, st.st_size + 1);
+        close(fd);
+        return NULL;
+    }
+
+    close(fd);
+    *size = st.st_size;
+
+    return result;
+#endif
+}
+
+/**
+ * Releases a response file mapped by arguments_response_map.
+ *
+ * @param data
+ *     The contents of the file.
+ * @param size
+ *     The size of the file.
+ */
+static void
+arguments_response_unmap(char *data, size_t size)
+{
+#if defined(WIN32)
+    free(data);
+    (void)size;
+#else
+    munmap(data, size + 1);
+#endif
+}
+
+/**
+ * Splits the contents of a response file into command line arguments.
+ *
+ * Command line arguments are separated by white space. White space may be
+ * included in a command line argument by enclosing it in single or double
+ * quotes, or by escaping it with a backslash.
+ *
+ * The contents are modified in place to unquote and terminate every command
+ * line argument, so no strings are copied.
+ *
+ * @param data
+ *     The NUL terminated contents of the response file.
+ * @param tokens
+ *     The command line arguments are written to this array. If this is NULL,
+ *     the command line arguments are only counted, and data is not modified.
+ * @return the number of command line arguments
+ */
+static unsigned int
+arguments_response_tokenize(char *data, char **tokens)
+{
+    unsigned int result = 0;
+    char *r = data;
+
+    for (;;) {
+        char *w;
+        char quote = 0;
+
+        /* Skip leading white space */
+        while (*r && isspace((unsigned char)*r)) {
+            r++;
+        }
+        if (!*r) {
+            break;
+        }
+
+        if (tokens) {
+            tokens[result] = r;
+        }
+        result++;
+
+        for (w = r; *r && (quote || !isspace((unsigned char)*r)); r++) {
+            if (quote && (*r == quote)) {
+                quote = 0;
+                continue;
+            }
+            else if (!quote && ((*r == '"') || (*r == '\''))) {
+                quote = *r;
+                continue;
+            }
+            else if ((*r == '\\') && (quote != '\'') && r[1]) {
+                r++;
+            }
+
+            if (tokens) {
+                *w = *r;
+            }
+            w++;
+        }
+
+        /* Terminate the command line argument; the reader is always at or
+           ahead of the writer, so this never overwrites unread data */
+        if (*r) {
+            r++;
+        }
+        if (tokens) {
+            *w = '\0';
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Releases the response files and the expanded command line.
+ *
+ * @param responses
+ *     The response files.
+ */
+static void
+arguments_response_release(struct arguments_responses_t *responses)
+{
+    unsigned int i;
+
+    for (i = 0; i < responses->length; i++) {
+        if (responses->files[i].data) {
+            arguments_response_unmap(responses->files[i].data,
+                responses->files[i].size);
+        }
+    }
+
+    free(responses->files);
+    free(responses->argv);
+    memset(responses, 0, sizeof(*responses));
+}
+
+/**
+ * Expands response files on the command line.
+ *
+ * Every command line argument on the form @path is replaced with the command
+ * line arguments read from the file path. If the file cannot be read, the
+ * command line argument is left as is. Response files are not expanded
+ * recursively, so a command line already expanded into responses is returned
+ * unchanged.
+ *
+ * The files are mapped into memory and split in place, and the expanded
+ * command line is allocated once, so no command line argument is copied.
+ * The expanded command line remains valid until responses is released.
+ *
+ * @param responses
+ *     The response files previously expanded, which are released if any
+ *     response file is found; the new ones are stored here.
+ * @param argc, argv
+ *     The command line. Upon successful return, these will contain the
+ *     expanded command line if any response file was found.
+ * @return AC_OK upon success, or AC_ERROR if memory could not be allocated
+ */
+static int
+arguments_response_expand(struct arguments_responses_t *responses, int *argc,
+    char ***argv)
+{
+    char **result;
+    unsigned int count, total, i, j, k;
+
+    /* Count the response files first */
+    count = 0;
+    for (i = 1; i < (unsigned int)*argc; i++) {
+        if (((*argv)[i][0] == '@') && (*argv)[i][1]) {
+            count++;
+        }
+    }
+    if (!count || (*argv == responses->argv)) {
+        return AC_OK;
+    }
+
+    arguments_response_release(responses);
+    responses->files = (struct arguments_response_t*)calloc(count,
+        sizeof(*responses->files));
+    if (!responses->files) {
+        return AC_ERROR;
+    }
+    responses->length = count;
+
+    /* Map all response files and count their command line arguments to
+       calculate the size of the expanded command line */
+    total = *argc;
+    for (i = 1, j = 0; i < (unsigned int)*argc; i++) {
+        if (((*argv)[i][0] == '@') && (*argv)[i][1]) {
+            struct arguments_response_t *response = &responses->files[j++];
+
+            response->data = arguments_response_map((*argv)[i] + 1,
+                &response->size);
+            if (response->data) {
+                total += arguments_response_tokenize(response->data, NULL) - 1;
+            }
+        }
+    }
+
+    result = (char**)malloc((total + 1) * sizeof(*result));
+    if (!result) {
+        arguments_response_release(responses);
+        return AC_ERROR;
+    }
+
+    result[0] = (*argv)[0];
+    for (i = 1, j = 0, k = 1; i < (unsigned int)*argc; i++) {
+        if (((*argv)[i][0] == '@') && (*argv)[i][1]
+                && responses->files[j++].data) {
+            k += arguments_response_tokenize(responses->files[j - 1].data,
+                result + k);
+        }
+        else {
+            result[k++] = (*argv)[i];
+        }
+    }
+    result[k] = NULL;
+
+    responses->argc = k;
+    responses->argv = result;
+    *argc = k;
+    *argv = result;
+
+    return AC_OK;
+}
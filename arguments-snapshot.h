@@ -0,0 +1,538 @@
+#if defined(WIN32)
+    #include <io.h>
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+#ifndef ARGUMENTS_CAST
+    #if defined(__cplusplus)
+        #define ARGUMENTS_CAST(pointer) (decltype(pointer))
+    #else
+        #define ARGUMENTS_CAST(pointer)
+    #endif
+#endif
+
+/**
+ * The name of the environment variable from which an automatic main reads the
+ * file descriptor of a snapshot to map.
+ */
+#ifndef ARGUMENTS_SNAPSHOT_ENVIRONMENT
+    #define ARGUMENTS_SNAPSHOT_ENVIRONMENT "ARGUMENTS_SNAPSHOT_FD"
+#endif
+
+/**
+ * These are the ready-made blocks that may be passed as save and load to the
+ * ARGUMENT_SNAPSHOT macro.
+ *
+ * ARGUMENT_SAVE_PLAIN and ARGUMENT_LOAD_PLAIN copy the bytes of the value, and
+ * may be used for any type that contains no pointers, such as integers and
+ * floating point numbers.
+ */
+#define ARGUMENT_SAVE_PLAIN \
+    arguments_snapshot_write(writer, target, sizeof(*target));
+#define ARGUMENT_LOAD_PLAIN \
+    is_valid = (size == sizeof(*target)); \
+    if (is_valid) { \
+        memcpy(target, data, size); \
+    }
+
+/**
+ * Saves and loads a string of the type char * or const char *, which may be
+ * NULL. The loaded string refers to the snapshot; it is not released, so the
+ * release block of the argument may free strings it has converted.
+ */
+#define ARGUMENT_SAVE_STRING \
+    if (*target) { \
+        arguments_snapshot_write(writer, *target, strlen(*target) + 1); \
+    }
+#define ARGUMENT_LOAD_STRING \
+    is_valid = !size || !data[size - 1]; \
+    if (is_valid) { \
+        *target = size ? data : NULL; \
+    }
+
+/**
+ * Saves and loads a list of the type ARGUMENT_LIST(type), where type contains
+ * no pointers, as read by the list readers. The loaded values refer to the
+ * snapshot and are not released.
+ */
+#define ARGUMENT_SAVE_LIST \
+    arguments_snapshot_write(writer, target->values, \
+        target->length * sizeof(*target->values));
+#define ARGUMENT_LOAD_LIST \
+    is_valid = (size % sizeof(*target->values) == 0); \
+    if (is_valid) { \
+        target->values = ARGUMENTS_CAST(target->values) (void*)data; \
+        target->length = size / sizeof(*target->values); \
+    }
+
+/**
+ * The alignment of the records in a snapshot, and of the snapshot itself.
+ */
+#define ARGUMENTS_SNAPSHOT_ALIGN \
+    sizeof(union arguments_arena_align_t)
+
+/**
+ * Returns the number of bytes needed to pad an offset to
+ * ARGUMENTS_SNAPSHOT_ALIGN.
+ */
+#define arguments_snapshot_padding(offset) \
+    ((ARGUMENTS_SNAPSHOT_ALIGN - (offset) % ARGUMENTS_SNAPSHOT_ALIGN) \
+        % ARGUMENTS_SNAPSHOT_ALIGN)
+
+/**
+ * The header of a snapshot.
+ *
+ *   * magic: ARGUMENTS_SNAPSHOT_MAGIC
+ *   * signature: the signature of the definitions in arguments.def that saved
+ *     the snapshot; see arguments_snapshot_signature
+ *   * count: the number of records following the header
+ *   * size: the size of the snapshot, including the header
+ */
+struct arguments_snapshot_header_t {
+    char magic[8];
+    unsigned int signature;
+    unsigned int count;
+    unsigned long long size;
+};
+
+/**
+ * The header of a record in a snapshot, which is followed by size bytes of
+ * data and padded to ARGUMENTS_SNAPSHOT_ALIGN.
+ *
+ *   * index: the index of the argument
+ *   * input: the hash of the command line values the argument was converted
+ *     from; see arguments_snapshot_input
+ *   * size: the size of the data
+ */
+struct arguments_snapshot_record_t {
+    unsigned int index;
+    unsigned int input;
+    unsigned long long size;
+};
+
+/**
+ * The magic string at the start of every snapshot.
+ */
+#define ARGUMENTS_SNAPSHOT_MAGIC "ARGSNAP"
+
+/**
+ * The types and names of all arguments, and the names of the arguments that
+ * may be saved, which identify the layout of struct arguments_t.
+ */
+static const char arguments_snapshot_layout[] = ""
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    #type " " #name ";"
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#undef ARGUMENT_SNAPSHOT
+#define ARGUMENT_SNAPSHOT(name, save, load) \
+    "+" #name ";"
+#include "../arguments.def"
+#undef ARGUMENT_SNAPSHOT
+#define ARGUMENT_SNAPSHOT(name, save, load)
+    ;
+
+/**
+ * Calculates a hash of a buffer, continuing a previous hash.
+ *
+ * @param hash
+ *     The previous hash, or 2166136261u to start a new hash.
+ * @param data
+ *     The data to hash.
+ * @param size
+ *     The size of data.
+ * @return the hash
+ */
+static unsigned int
+arguments_snapshot_hash(unsigned int hash, const void *data, size_t size)
+{
+    const unsigned char *c = (const unsigned char*)data;
+
+    while (size--) {
+        hash ^= *(c++);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * Returns the signature of the definitions in arguments.def, so that a
+ * snapshot saved by a different build is not loaded.
+ */
+static unsigned int
+arguments_snapshot_signature(void)
+{
+    size_t size = sizeof(struct arguments_t);
+    unsigned int result = arguments_snapshot_hash(2166136261u,
+        arguments_snapshot_layout, sizeof(arguments_snapshot_layout));
+
+    return arguments_snapshot_hash(result, &size, sizeof(size));
+}
+
+/**
+ * Calculates a hash of the command line values of an argument, so that a
+ * value is only loaded from a snapshot if it was converted from the same
+ * values.
+ *
+ * @param ctx
+ *     The context.
+ * @param index
+ *     The index of the argument.
+ * @return the hash
+ */
+static unsigned int
+arguments_snapshot_input(const struct arguments_context_t *ctx, int index)
+{
+    const struct arguments_strings_t *strings = &ctx->state->strings[index];
+    unsigned char is_present = (unsigned char)arguments_bit_get(
+        ctx->state->present, index);
+    unsigned int result = arguments_snapshot_hash(2166136261u, &is_present, 1);
+    unsigned int i;
+
+    if (is_present) {
+        for (i = 0; i < strings->value_strings_length; i++) {
+            result = arguments_snapshot_hash(result,
+                strings->value_strings[i],
+                strlen(strings->value_strings[i]) + 1);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * A growing buffer receiving a snapshot.
+ *
+ *   * data: the snapshot, allocated with malloc
+ *   * length: the number of bytes written
+ *   * size: the number of bytes allocated
+ *   * is_valid: whether all memory could be allocated
+ */
+struct arguments_snapshot_writer_t {
+    char *data;
+    size_t length;
+    size_t size;
+    int is_valid;
+};
+
+/**
+ * Appends data to a snapshot.
+ *
+ * @param writer
+ *     The snapshot.
+ * @param data
+ *     The data to append.
+ * @param size
+ *     The size of data.
+ */
+static void
+arguments_snapshot_write(struct arguments_snapshot_writer_t *writer,
+    const void *data, size_t size)
+{
+    if (!writer->is_valid) {
+        return;
+    }
+    else if (writer->length + size > writer->size) {
+        size_t new_size = writer->size ? 2 * writer->size : 256;
+        char *new_data;
+
+        while (new_size < writer->length + size) {
+            new_size *= 2;
+        }
+        new_data = (char*)realloc(writer->data, new_size);
+        if (!new_data) {
+            writer->is_valid = 0;
+            return;
+        }
+        writer->data = new_data;
+        writer->size = new_size;
+    }
+
+    if (size) {
+        memcpy(writer->data + writer->length, data, size);
+        writer->length += size;
+    }
+}
+
+/**
+ * Pads a snapshot with zeros to ARGUMENTS_SNAPSHOT_ALIGN.
+ *
+ * @param writer
+ *     The snapshot.
+ */
+static void
+arguments_snapshot_pad(struct arguments_snapshot_writer_t *writer)
+{
+    static const union arguments_arena_align_t zero = {0};
+
+    arguments_snapshot_write(writer, &zero,
+        arguments_snapshot_padding(writer->length));
+}
+
+/**
+ * Saves the values of a context that has been parsed into a snapshot.
+ *
+ * Only the arguments with an ARGUMENT_SNAPSHOT invocation in arguments.def that
+ * have been initialised are saved. The snapshot may be passed to processes
+ * running the same build with the same command line, which load it with
+ * arguments_load_snapshot instead of converting these arguments.
+ *
+ * @param ctx
+ *     The context.
+ * @param size
+ *     The size of the snapshot is written to this variable.
+ * @return the snapshot, which must be freed with free, or NULL if memory could
+ *     not be allocated
+ */
+static ARGUMENTS_UNUSED char *
+arguments_save_snapshot(const struct arguments_context_t *ctx, size_t *size)
+{
+    struct arguments_snapshot_writer_t snapshot = {NULL, 0, 0, 1};
+    struct arguments_snapshot_writer_t *writer = &snapshot;
+    struct arguments_snapshot_header_t header;
+
+    memset(&header, 0, sizeof(header));
+    arguments_snapshot_write(writer, &header, sizeof(header));
+    arguments_snapshot_pad(writer);
+
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release)
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#undef ARGUMENT_SNAPSHOT
+#define ARGUMENT_SNAPSHOT(name, save, load) \
+    if (arguments_bit_get(ctx->state->initialized, AI_##name)) { \
+        struct arguments_snapshot_record_t record; \
+        size_t start = writer->length; \
+        \
+        record.index = AI_##name; \
+        record.input = arguments_snapshot_input(ctx, AI_##name); \
+        record.size = 0; \
+        arguments_snapshot_write(writer, &record, sizeof(record)); \
+        arguments_snapshot_pad(writer); \
+        do { \
+            const name##_t *target = &ctx->values->name; \
+            \
+            save \
+        } while (0); \
+        \
+        /* The record is completed once the size of the data is known */ \
+        if (writer->is_valid) { \
+            record.size = writer->length - start - sizeof(record) \
+                - arguments_snapshot_padding(sizeof(record)); \
+            memcpy(writer->data + start, &record, sizeof(record)); \
+            header.count++; \
+        } \
+        arguments_snapshot_pad(writer); \
+    }
+#include "../arguments.def"
+#undef ARGUMENT_SNAPSHOT
+#define ARGUMENT_SNAPSHOT(name, save, load)
+
+    if (!writer->is_valid) {
+        free(writer->data);
+        return NULL;
+    }
+
+    memcpy(header.magic, ARGUMENTS_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.signature = arguments_snapshot_signature();
+    header.size = writer->length;
+    memcpy(writer->data, &header, sizeof(header));
+
+    *size = writer->length;
+
+    return writer->data;
+}
+
+/**
+ * Loads the values of the snapshot of a context, which is set with
+ * arguments_map_snapshot or by assigning the snapshot and snapshot_size fields
+ * of the context.
+ *
+ * This is called by arguments_set_ctx once the command line has been scanned.
+ * A value is only loaded if its argument is matched on the current command
+ * line and has the same command line values as when the snapshot was saved;
+ * the arguments that are not loaded are converted as usual. The loaded
+ * arguments are marked as initialised and as loaded; their release blocks are
+ * not executed, since their values refer to the snapshot, which is unmapped
+ * with the context.
+ *
+ * @param ctx
+ *     The context.
+ * @return AC_OK, or AC_ERROR if the snapshot is not valid or was saved by a
+ *     different build, in which case nothing is loaded
+ */
+static int
+arguments_load_snapshot(struct arguments_context_t *ctx)
+{
+    struct arguments_snapshot_header_t header;
+    char *current, *end;
+    unsigned int i;
+
+    if ((ctx->snapshot_size < sizeof(header))
+            || ((size_t)ctx->snapshot % ARGUMENTS_SNAPSHOT_ALIGN)) {
+        return AC_ERROR;
+    }
+    memcpy(&header, ctx->snapshot, sizeof(header));
+    if ((memcmp(header.magic, ARGUMENTS_SNAPSHOT_MAGIC,
+                sizeof(header.magic)) != 0)
+            || (header.signature != arguments_snapshot_signature())
+            || (header.size > ctx->snapshot_size)) {
+        return AC_ERROR;
+    }
+
+    current = ctx->snapshot + sizeof(header);
+    end = ctx->snapshot + header.size;
+    for (i = 0; i < header.count; i++) {
+        struct arguments_snapshot_record_t record;
+        char *data;
+        size_t size;
+
+        /* Records are padded, so every record and its data start aligned */
+        current += arguments_snapshot_padding(
+            (size_t)(current - ctx->snapshot));
+        if ((current > end)
+                || ((size_t)(end - current) < sizeof(record)
+                    + arguments_snapshot_padding(sizeof(record)))) {
+            return AC_ERROR;
+        }
+        memcpy(&record, current, sizeof(record));
+        data = current + sizeof(record)
+            + arguments_snapshot_padding(sizeof(record));
+        if (record.size > (size_t)(end - data)) {
+            return AC_ERROR;
+        }
+        size = (size_t)record.size;
+        current = data + size;
+
+        if ((record.index >= ARGUMENTS_COUNT)
+                || !arguments_is_visible(record.index, ctx->state->command)
+                || (record.input
+                    != arguments_snapshot_input(ctx, record.index))) {
+            continue;
+        }
+
+        switch (record.index) {
+#undef ARGUMENT_SNAPSHOT
+#define ARGUMENT_SNAPSHOT(name, save, load) \
+        case AI_##name: { \
+            int is_valid = 1; \
+            name##_t *target = &ctx->values->name; \
+            struct arguments_arena_t *arena = &ctx->arena; \
+            \
+            load \
+            \
+            /* A value that could not be loaded is converted instead */ \
+            if (is_valid) { \
+                arguments_bit_set(ctx->state->initialized, AI_##name); \
+                arguments_bit_set(ctx->state->loaded, AI_##name); \
+            } \
+            else { \
+                memset(target, 0, sizeof(*target)); \
+            } \
+            if (arena); \
+            break; \
+        }
+#include "../arguments.def"
+#undef ARGUMENT_SNAPSHOT
+#define ARGUMENT_SNAPSHOT(name, save, load)
+
+        default:
+            break;
+        }
+
+        if (data);
+        if (size);
+    }
+
+    return AC_OK;
+}
+
+/**
+ * Unmaps the snapshot of a context, if it was mapped by
+ * arguments_map_snapshot.
+ *
+ * @param ctx
+ *     The context.
+ */
+static void
+arguments_unmap_snapshot(struct arguments_context_t *ctx)
+{
+    if (ctx->is_snapshot_mapped) {
+#if defined(WIN32)
+        UnmapViewOfFile(ctx->snapshot);
+#else
+        munmap(ctx->snapshot, ctx->snapshot_size);
+#endif
+        ctx->snapshot = NULL;
+        ctx->snapshot_size = 0;
+        ctx->is_snapshot_mapped = 0;
+    }
+}
+
+/**
+ * Maps a snapshot from a file descriptor into a context, for example a file
+ * or shared memory segment inherited from the process that saved it.
+ *
+ * The mapping is private, and is kept until the context is released, so the
+ * loaded values remain valid for as long as the context.
+ *
+ * @param ctx
+ *     The context.
+ * @param fd
+ *     The file descriptor. It may be closed once this function has returned.
+ * @return AC_OK, or AC_ERROR if the file could not be mapped
+ */
+static ARGUMENTS_UNUSED int
+arguments_map_snapshot(struct arguments_context_t *ctx, int fd)
+{
+#if defined(WIN32)
+    HANDLE file = (HANDLE)_get_osfhandle(fd), mapping;
+    LARGE_INTEGER size;
+    char *snapshot;
+
+    if ((file == INVALID_HANDLE_VALUE) || !GetFileSizeEx(file, &size)
+            || !size.QuadPart) {
+        return AC_ERROR;
+    }
+    mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (!mapping) {
+        return AC_ERROR;
+    }
+    snapshot = (char*)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!snapshot) {
+        return AC_ERROR;
+    }
+#else
+    struct stat info;
+    void *snapshot;
+
+    if ((fstat(fd, &info) != 0) || !info.st_size) {
+        return AC_ERROR;
+    }
+    snapshot = mmap(NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+        fd, 0);
+    if (snapshot == MAP_FAILED) {
+        return AC_ERROR;
+    }
+#endif
+
+    arguments_unmap_snapshot(ctx);
+    ctx->snapshot = (char*)snapshot;
+#if defined(WIN32)
+    ctx->snapshot_size = (size_t)size.QuadPart;
+#else
+    ctx->snapshot_size = info.st_size;
+#endif
+    ctx->is_snapshot_mapped = 1;
+
+    return AC_OK;
+}
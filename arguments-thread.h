@@ -0,0 +1,362 @@
+#if defined(WIN32)
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <sched.h>
+    #include <time.h>
+#endif
+
+/**
+ * Atomically reads an int.
+ *
+ * The read has acquire semantics, so everything written before the value was
+ * stored with arguments_atomic_store is visible after it has been read.
+ *
+ * @param p
+ *     A pointer to the int.
+ */
+#if defined(_MSC_VER)
+    #define arguments_atomic_load(p) \
+        InterlockedCompareExchange((volatile LONG*)(p), 0, 0)
+#else
+    #define arguments_atomic_load(p) \
+        __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#endif
+
+/**
+ * Atomically writes an int.
+ *
+ * The write has release semantics.
+ *
+ * @param p
+ *     A pointer to the int.
+ * @param value
+ *     The value to write.
+ */
+#if defined(_MSC_VER)
+    #define arguments_atomic_store(p, value) \
+        InterlockedExchange((volatile LONG*)(p), (value))
+#else
+    #define arguments_atomic_store(p, value) \
+        __atomic_store_n((p), (value), __ATOMIC_RELEASE)
+#endif
+
+/**
+ * Atomically reads an unsigned char, with acquire semantics.
+ *
+ * @param p
+ *     A pointer to the unsigned char.
+ */
+#if defined(_MSC_VER)
+    #define arguments_atomic_load_byte(p) \
+        ((unsigned char)_InterlockedOr8((volatile char*)(p), 0))
+#else
+    #define arguments_atomic_load_byte(p) \
+        __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#endif
+
+/**
+ * Atomically sets bits in an unsigned char, with release semantics.
+ *
+ * @param p
+ *     A pointer to the unsigned char.
+ * @param bits
+ *     The bits to set.
+ */
+#if defined(_MSC_VER)
+    #define arguments_atomic_or_byte(p, bits) \
+        _InterlockedOr8((volatile char*)(p), (char)(bits))
+#else
+    #define arguments_atomic_or_byte(p, bits) \
+        __atomic_fetch_or((p), (bits), __ATOMIC_RELEASE)
+#endif
+
+/**
+ * Atomically replaces an int if it has an expected value.
+ *
+ * @param p
+ *     A pointer to the int.
+ * @param expected
+ *     The expected value.
+ * @param desired
+ *     The value to write if *p is expected.
+ * @return non-zero if the value was replaced, or 0 otherwise
+ */
+#if defined(_MSC_VER)
+    #define arguments_atomic_cas(p, expected, desired) \
+        (InterlockedCompareExchange((volatile LONG*)(p), (desired), \
+            (expected)) == (expected))
+#else
+    #define arguments_atomic_cas(p, expected, desired) \
+        __extension__ ({ \
+            int arguments_expected = (expected); \
+            __atomic_compare_exchange_n((p), &arguments_expected, (desired), \
+                0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE); \
+        })
+#endif
+
+/**
+ * Atomically adds to an int.
+ *
+ * The addition is sequentially consistent, so it is ordered with respect to
+ * all other sequentially consistent operations.
+ *
+ * @param p
+ *     A pointer to the int.
+ * @param value
+ *     The value to add.
+ * @return the previous value
+ */
+#if defined(_MSC_VER)
+    #define arguments_atomic_add(p, value) \
+        InterlockedExchangeAdd((volatile LONG*)(p), (value))
+#else
+    #define arguments_atomic_add(p, value) \
+        __atomic_fetch_add((p), (value), __ATOMIC_SEQ_CST)
+#endif
+
+/**
+ * Atomically reads and writes a pointer.
+ *
+ * Both operations are sequentially consistent. The value read is a void *.
+ *
+ * @param p
+ *     A pointer to the pointer.
+ * @param value
+ *     The value to write.
+ */
+#if defined(_MSC_VER)
+    #define arguments_atomic_load_pointer(p) \
+        InterlockedCompareExchangePointer((PVOID volatile*)(p), NULL, NULL)
+    #define arguments_atomic_store_pointer(p, value) \
+        InterlockedExchangePointer((PVOID volatile*)(p), (value))
+#else
+    #define arguments_atomic_load_pointer(p) \
+        ((void*)__atomic_load_n((p), __ATOMIC_SEQ_CST))
+    #define arguments_atomic_store_pointer(p, value) \
+        __atomic_store_n((p), (value), __ATOMIC_SEQ_CST)
+#endif
+
+/**
+ * Yields the processor to another thread.
+ */
+#if defined(WIN32)
+    #define arguments_thread_yield() \
+        SwitchToThread()
+#else
+    #define arguments_thread_yield() \
+        sched_yield()
+#endif
+
+
+/**
+ * Sleeps for a millisecond.
+ */
+static ARGUMENTS_UNUSED void
+arguments_thread_sleep(void)
+{
+#if defined(WIN32)
+    Sleep(1);
+#else
+    struct timespec duration;
+
+    duration.tv_sec = 0;
+    duration.tv_nsec = 1000000;
+    nanosleep(&duration, NULL);
+#endif
+}
+
+/**
+ * A thread, a mutex and a condition variable.
+ */
+#if defined(WIN32)
+    typedef HANDLE arguments_thread_t;
+    typedef CRITICAL_SECTION arguments_mutex_t;
+    typedef CONDITION_VARIABLE arguments_cond_t;
+#else
+    typedef pthread_t arguments_thread_t;
+    typedef pthread_mutex_t arguments_mutex_t;
+    typedef pthread_cond_t arguments_cond_t;
+#endif
+
+/**
+ * Declares a thread function.
+ *
+ * A thread function returns ARGUMENTS_THREAD_RESULT.
+ *
+ * @param name
+ *     The name of the function.
+ * @param arg
+ *     The name of the void * parameter of the function.
+ */
+#if defined(WIN32)
+    #define ARGUMENTS_THREAD_FUNCTION(name, arg) \
+        static DWORD WINAPI name(LPVOID arg)
+    #define ARGUMENTS_THREAD_RESULT 0
+#else
+    #define ARGUMENTS_THREAD_FUNCTION(name, arg) \
+        static void *name(void *arg)
+    #define ARGUMENTS_THREAD_RESULT NULL
+#endif
+
+/**
+ * Starts a thread.
+ *
+ * @param thread
+ *     A pointer to the thread to start.
+ * @param function
+ *     The thread function, declared with ARGUMENTS_THREAD_FUNCTION.
+ * @param arg
+ *     The argument passed to function.
+ * @return non-zero if the thread was started, or 0 otherwise
+ */
+#if defined(WIN32)
+    #define arguments_thread_start(thread, function, arg) \
+        ((*(thread) = CreateThread(NULL, 0, (function), (arg), 0, NULL)) \
+            != NULL)
+    #define arguments_thread_join(thread) \
+        (WaitForSingleObject((thread), INFINITE), CloseHandle(thread))
+#else
+    #define arguments_thread_start(thread, function, arg) \
+        (pthread_create((thread), NULL, (function), (arg)) == 0)
+    #define arguments_thread_join(thread) \
+        pthread_join((thread), NULL)
+#endif
+
+/**
+ * Operations on mutexes and condition variables.
+ */
+#if defined(WIN32)
+    #define arguments_mutex_init(mutex) InitializeCriticalSection(mutex)
+    #define arguments_mutex_destroy(mutex) DeleteCriticalSection(mutex)
+    #define arguments_mutex_lock(mutex) EnterCriticalSection(mutex)
+    #define arguments_mutex_unlock(mutex) LeaveCriticalSection(mutex)
+    #define arguments_cond_init(cond) InitializeConditionVariable(cond)
+    #define arguments_cond_destroy(cond)
+    #define arguments_cond_wait(cond, mutex) \
+        SleepConditionVariableCS((cond), (mutex), INFINITE)
+    #define arguments_cond_broadcast(cond) WakeAllConditionVariable(cond)
+#else
+    #define arguments_mutex_init(mutex) pthread_mutex_init((mutex), NULL)
+    #define arguments_mutex_destroy(mutex) pthread_mutex_destroy(mutex)
+    #define arguments_mutex_lock(mutex) pthread_mutex_lock(mutex)
+    #define arguments_mutex_unlock(mutex) pthread_mutex_unlock(mutex)
+    #define arguments_cond_init(cond) pthread_cond_init((cond), NULL)
+    #define arguments_cond_destroy(cond) pthread_cond_destroy(cond)
+    #define arguments_cond_wait(cond, mutex) pthread_cond_wait((cond), (mutex))
+    #define arguments_cond_broadcast(cond) pthread_cond_broadcast(cond)
+#endif
+
+/**
+ * A mutex and a condition variable that are initialised statically with
+ * ARGUMENTS_STATIC_MUTEX_INIT and ARGUMENTS_STATIC_COND_INIT, and never
+ * destroyed.
+ */
+#if defined(WIN32)
+    typedef SRWLOCK arguments_static_mutex_t;
+    typedef CONDITION_VARIABLE arguments_static_cond_t;
+    #define ARGUMENTS_STATIC_MUTEX_INIT SRWLOCK_INIT
+    #define ARGUMENTS_STATIC_COND_INIT CONDITION_VARIABLE_INIT
+    #define arguments_static_mutex_lock(mutex) \
+        AcquireSRWLockExclusive(mutex)
+    #define arguments_static_mutex_unlock(mutex) \
+        ReleaseSRWLockExclusive(mutex)
+    #define arguments_static_cond_wait(cond, mutex) \
+        SleepConditionVariableSRW((cond), (mutex), INFINITE, 0)
+    #define arguments_static_cond_broadcast(cond) \
+        WakeAllConditionVariable(cond)
+#else
+    typedef pthread_mutex_t arguments_static_mutex_t;
+    typedef pthread_cond_t arguments_static_cond_t;
+    #define ARGUMENTS_STATIC_MUTEX_INIT PTHREAD_MUTEX_INITIALIZER
+    #define ARGUMENTS_STATIC_COND_INIT PTHREAD_COND_INITIALIZER
+    #define arguments_static_mutex_lock(mutex) pthread_mutex_lock(mutex)
+    #define arguments_static_mutex_unlock(mutex) pthread_mutex_unlock(mutex)
+    #define arguments_static_cond_wait(cond, mutex) \
+        pthread_cond_wait((cond), (mutex))
+    #define arguments_static_cond_broadcast(cond) \
+        pthread_cond_broadcast(cond)
+#endif
+
+
+/**
+ * The states of a once flag.
+ */
+enum {
+    /**
+     * The action has not yet been started.
+     */
+    AO_NONE,
+
+    /**
+     * The action is being performed by a thread.
+     */
+    AO_BUSY,
+
+    /**
+     * The action has completed.
+     */
+    AO_DONE
+};
+
+/**
+ * The mutex and the condition variable with which threads wait for the
+ * actions of once flags started by other threads to complete.
+ */
+static arguments_static_mutex_t arguments_once_mutex =
+    ARGUMENTS_STATIC_MUTEX_INIT;
+static arguments_static_cond_t arguments_once_cond =
+    ARGUMENTS_STATIC_COND_INIT;
+
+/**
+ * Begins an action guarded by a once flag.
+ *
+ * If this function returns non-zero, the caller must perform the action and
+ * then call arguments_once_end. If it returns 0, the action has already been
+ * completed, possibly by another thread while this function was waiting.
+ *
+ * A completed action is detected without locking. A thread waiting for an
+ * action started by another thread blocks on a condition variable, which is
+ * signalled as soon as the action completes.
+ *
+ * @param once
+ *     The once flag.
+ * @return non-zero if the caller must perform the action, or 0 otherwise
+ */
+static ARGUMENTS_UNUSED int
+arguments_once_begin(int *once)
+{
+    if (arguments_atomic_load(once) == AO_DONE) {
+        return 0;
+    }
+    else if (arguments_atomic_cas(once, AO_NONE, AO_BUSY)) {
+        return 1;
+    }
+
+    arguments_static_mutex_lock(&arguments_once_mutex);
+    while (arguments_atomic_load(once) != AO_DONE) {
+        arguments_static_cond_wait(&arguments_once_cond,
+            &arguments_once_mutex);
+    }
+    arguments_static_mutex_unlock(&arguments_once_mutex);
+
+    return 0;
+}
+
+/**
+ * Completes an action started with arguments_once_begin, and wakes the
+ * threads waiting for it.
+ *
+ * @param once
+ *     The once flag.
+ */
+static ARGUMENTS_UNUSED void
+arguments_once_end(int *once)
+{
+    /* The flag is set with the mutex held, so a waiting thread either sees
+       it before waiting or is woken */
+    arguments_static_mutex_lock(&arguments_once_mutex);
+    arguments_atomic_store(once, AO_DONE);
+    arguments_static_cond_broadcast(&arguments_once_cond);
+    arguments_static_mutex_unlock(&arguments_once_mutex);
+}
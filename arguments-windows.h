@@ -0,0 +1,93 @@
+#include <windows.h>
+
+/**
+ * Returns the length of a wide character string if it consists only of ASCII
+ * characters.
+ *
+ * @param s
+ *     The string to investigate.
+ * @return the number of characters in s, or (size_t)-1 if s contains a
+ *     character outside ASCII
+ */
+static size_t
+arguments_wide_ascii_length(const wchar_t *s)
+{
+    size_t result;
+
+    for (result = 0; s[result]; result++) {
+        if ((unsigned long)s[result] >= 0x80) {
+            return (size_t)-1;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Converts a wide character command line to UTF-8.
+ *
+ * The argument vector and all strings are stored in a single allocation, so
+ * the result is freed with a single call to free. The sizes of all strings are
+ * determined before anything is converted; strings consisting only of ASCII
+ * characters are copied without calling WideCharToMultiByte.
+ *
+ * @param argc, wargv
+ *     The wide character command line.
+ * @return the argument vector, terminated by NULL, or NULL if memory could not
+ *     be allocated
+ */
+static ARGUMENTS_UNUSED char **
+arguments_argv_from_wide(int argc, wchar_t *wargv[])
+{
+    size_t size = (argc + 1) * sizeof(char*);
+    char **result, *current, *end;
+    int i;
+
+    /* Determine the size of all arguments; an argument that cannot be
+       converted becomes empty */
+    for (i = 0; i < argc; i++) {
+        size_t length = arguments_wide_ascii_length(wargv[i]);
+
+        if (length == (size_t)-1) {
+            length = (size_t)WideCharToMultiByte(CP_UTF8, 0, wargv[i], -1,
+                NULL, 0, NULL, NULL);
+            length = length ? length - 1 : 0;
+        }
+        size += length + 1;
+    }
+
+    result = (char**)malloc(size);
+    if (!result) {
+        return NULL;
+    }
+
+    /* Convert all arguments into the space following the argument vector */
+    current = (char*)(result + argc + 1);
+    end = (char*)result + size;
+    for (i = 0; i < argc; i++) {
+        size_t length = arguments_wide_ascii_length(wargv[i]);
+
+        result[i] = current;
+        if (length != (size_t)-1) {
+            size_t j;
+
+            for (j = 0; j <= length; j++) {
+                current[j] = (char)wargv[i][j];
+            }
+            current += length + 1;
+        }
+        else {
+            int written = WideCharToMultiByte(CP_UTF8, 0, wargv[i], -1,
+                current, (int)(end - current), NULL, NULL);
+
+            if (!written) {
+                *current = '\0';
+                written = 1;
+            }
+            current += written;
+        }
+    }
+    result[argc] = NULL;
+
+    return result;
+}
@@ -3,101 +3,33 @@
 
 #include <memory.h>
 
-/**
- * This is the macro used to define command line parameters. Create the file
- * arguments.def and populate it with invocations of this macro.
- *
- * The order of the arguments found in arguments.def needs to reflect the
- * parameters to to the run function if ARGUMENTS_AUTOMATIC is defined.
- *
- * @param type
- *     The type of the variable that stores the parsed value of this argument.
- *
- * @param name
- *     The name of the variable, and also the long argument name. The long
- *     argument name is constructed by prepending two dashes to the name and
- *     then replacing all underscores with dashes.
- *
- * @param short
- *     The short command line argument name. This may not be NULL; use
- *     ARGUMENT_NO_SHORT_OPTION if the argument hs no short option.
- *
- * @param help
- *     The help text for the argument. The first occurrence of "%s" in this
- *     message will be replaced by the default value.
- *
- * @param value_count
- *     The number of parameters following the named parameter that are required.
- *
- * @param is_required
- *     Whether this argument is required on the command line. The value for
- *     is_required is evaluated once all arguments have been read, so it may
- *     depend on arguments passed on the command line.
- *
- * @param set_default
- *     A list of statements executed when the argument has not been passed on
- *     the command line. The following variables are available to the code:
- *       - type *target: a pointer to the variable to receive the value.
- *     If there is not suitable default value for the argument, pass
- *     ARGUMENTS_NO_DEFAULT.
- *
- * @param read
- *     A list of statements used to actually set the value of the variable. The
- *     following variables are available to the code:
- *       - type *target: a pointer to the variable to receive the value.
- *       - const char **value_strings: the actual values passed.
- *       - int value_strings_length: the number of values passed.
- *       - int is_valid: whether the value passed was valid; set this to 0 if
- *         the argument variable could not be initialised.
- *
- * @param release
- *     A list of statements used to release any resources used by the variable;
- *     this may be closing files, or freeing allocated memory. The following
- *     variables are available to the code:
- *       - type *target: a pointer to the variable that received the value.
- */
-#define ARGUMENT(type, name, short, help, value_count, is_required, \
-    set_default, read, release)
-
-/**
- * This is the macro used to separate command line parameters into natural
- * sections. Use this macro to group arguments.
- *
- * The group is only used when printing the help text.
- *
- * @param text
- *     The text to insert before the section is displayed.
- */
-#define ARGUMENT_SECTION(text)
-
-/**
- * Pass this value as short if the argument does not have a short name.
- */
-#define ARGUMENT_NO_SHORT_OPTION ""
+#include "arguments-common.h"
 
 /**
- * Pass this value as is_required to the ARGUMENT macro if the argument is
- * required.
+ * Checks that a command line argument has been passed.
  */
-#define ARGUMENT_IS_REQUIRED 1
+#define ARGUMENT_IS_PRESENT(name) \
+    arguments_bit_get(arguments_current_state->present, AI_##name)
 
 /**
- * Pass this value as is_required to the ARGUMENT macro if the argument is not
- * required.
+ * Returns where the value of an argument was found; this is one of the AS_
+ * constants.
  */
-#define ARGUMENT_IS_OPTIONAL 0
+#define ARGUMENT_SOURCE(name) \
+    (arguments_current_state->sources[AI_##name])
 
 /**
- * Checks that a command line argument has been passed.
+ * Returns the command selected on the command line; this is ACMD_NONE or one of
+ * the ACMD_ constants.
  */
-#define ARGUMENT_IS_PRESENT(name) \
-    arguments.name.present
+#define ARGUMENT_SELECTED_COMMAND \
+    (arguments_current_state->command)
 
 /**
  * Reads the value of an argument
  */
 #define ARGUMENT_VALUE(name) \
-    arguments.name.value
+    arguments_current->name
 
 /**
  * We include arguments.def to define anything in the ARGUMENTS_HELPERS section
@@ -111,6 +43,47 @@
 #define ARGUMENT_SECTION(text)
 #include "../arguments.def"
 
+/**
+ * The indices of the arguments.
+ *
+ * For every argument, the constant AI_name is defined. The indices reflect the
+ * order of the arguments in arguments.def, and ARGUMENTS_COUNT is the total
+ * number of arguments.
+ */
+enum {
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    AI_##name,
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#include "../arguments.def"
+    ARGUMENTS_COUNT
+};
+
+/**
+ * The indices of the commands.
+ *
+ * For every command, the constant ACMD_name is defined. ACMD_NONE means that no
+ * command has been selected, and ARGUMENTS_COMMAND_COUNT is the number of
+ * commands plus one.
+ */
+enum {
+    ACMD_NONE,
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release)
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help) \
+    ACMD_##name,
+#include "../arguments.def"
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help)
+    ARGUMENTS_COMMAND_COUNT
+};
+
 /**
  * Whether to use this file in automatic mode.
  */
@@ -128,6 +101,15 @@
     #define ARGUMENTS_PRINT_HELP 1
 #endif
 
+/**
+ * Whether to keep all help texts in a single object in a section of their
+ * own, so that their pages are only loaded when the help is rendered. The
+ * help texts must then be string literals.
+ */
+#ifndef ARGUMENTS_COLD_HELP
+    #define ARGUMENTS_COLD_HELP 0
+#endif
+
 /**
  * The return code when an invalid command line parameter is encountered.
  */
@@ -142,37 +124,310 @@
     #define ARGUMENTS_PARAMETER_MISSING 120
 #endif
 
+/**
+ * Whether to look up long arguments in a hash table instead of comparing them
+ * to the name of every argument in turn. With the hash table, the time taken
+ * to parse a command line does not depend on the number of arguments.
+ */
+#ifndef ARGUMENTS_DISPATCH_HASH
+    #define ARGUMENTS_DISPATCH_HASH 1
+#endif
+
+/**
+ * Whether to accept several single character short arguments bundled into one
+ * command line argument, such as -abc for -a -b -c.
+ */
+#ifndef ARGUMENTS_SHORT_BUNDLES
+    #define ARGUMENTS_SHORT_BUNDLES 1
+#endif
+
+/**
+ * Whether a long command line argument that is not the long argument of any
+ * argument, but an unambiguous prefix of one, such as --verb for --verbose,
+ * matches that argument.
+ */
+#ifndef ARGUMENTS_ABBREVIATIONS
+    #define ARGUMENTS_ABBREVIATIONS 0
+#endif
+
+/**
+ * Whether arguments_scan reads arguments following positional arguments.
+ *
+ * If this is zero, the first positional argument terminates the arguments, as
+ * required by POSIX.
+ */
+#ifndef ARGUMENTS_PERMUTE
+    #define ARGUMENTS_PERMUTE 1
+#endif
+
+/**
+ * Whether to expand command line arguments on the form @path with the contents
+ * of the file path.
+ */
+#ifndef ARGUMENTS_RESPONSE_FILES
+    #define ARGUMENTS_RESPONSE_FILES 0
+#endif
+
+/**
+ * Whether to support reading argument values from configuration files with
+ * arguments_read_config.
+ */
+#ifndef ARGUMENTS_CONFIG_FILES
+    #define ARGUMENTS_CONFIG_FILES 0
+#endif
+
+/**
+ * The configuration file read by arguments_scan into the global variables, or
+ * NULL to read none. This is only used if ARGUMENTS_CONFIG_FILES is non-zero.
+ */
+#ifndef ARGUMENTS_CONFIG_FILE
+    #define ARGUMENTS_CONFIG_FILE NULL
+#endif
+
+/**
+ * Whether to convert the value of an argument the first time it is read
+ * instead of in arguments_set.
+ *
+ * This must be defined identically in all source files that include
+ * arguments.h.
+ */
+#ifndef ARGUMENTS_LAZY
+    #define ARGUMENTS_LAZY 0
+#endif
+
+/**
+ * The number of worker threads used to convert arguments with the flag
+ * ARGUMENT_INDEPENDENT in arguments_set.
+ *
+ * If this is zero, all arguments are converted on the calling thread.
+ */
+#ifndef ARGUMENTS_PARALLEL
+    #define ARGUMENTS_PARALLEL 0
+#endif
+
+/**
+ * Whether to provide the ready-made readers ARGUMENT_READ_INT and friends.
+ */
+#ifndef ARGUMENTS_READERS
+    #define ARGUMENTS_READERS 1
+#endif
+
+/**
+ * Whether arguments with the flag ARGUMENT_DEBUG_RELEASE are released when the
+ * process terminates. Enable this for builds checked for memory leaks.
+ */
+#ifndef ARGUMENTS_LEAK_CHECK
+    #ifdef NDEBUG
+        #define ARGUMENTS_LEAK_CHECK 0
+    #else
+        #define ARGUMENTS_LEAK_CHECK 1
+    #endif
+#endif
+
+/**
+ * Whether the automatic main may terminate the process with _Exit after run
+ * has returned, skipping arguments_release, if no argument needs to be
+ * released.
+ *
+ * Functions registered with atexit by run are then not called. This is not
+ * used if ARGUMENTS_LAZY or ARGUMENTS_RELOAD is non-zero.
+ */
+#ifndef ARGUMENTS_FAST_EXIT
+    #define ARGUMENTS_FAST_EXIT 0
+#endif
+
+/**
+ * Whether to support saving converted values to snapshots and loading them
+ * instead of converting them. This is not used if ARGUMENTS_LAZY is non-zero.
+ */
+#ifndef ARGUMENTS_SNAPSHOTS
+    #define ARGUMENTS_SNAPSHOTS 0
+#endif
+
+/**
+ * Whether to support reloading the arguments while the program runs, and
+ * reading the latest values in read sections on any thread. This is not used
+ * if ARGUMENTS_LAZY is non-zero.
+ */
+#ifndef ARGUMENTS_RELOAD
+    #define ARGUMENTS_RELOAD 0
+#endif
+
+/**
+ * Whether to measure the time spent in the blocks of arguments.def and in
+ * arguments_setup and arguments_teardown.
+ */
+#ifndef ARGUMENTS_PROFILE
+    #define ARGUMENTS_PROFILE 0
+#endif
+
+#if ARGUMENTS_LAZY
+    /* Values are read through accessors that convert them on first access */
+    #undef ARGUMENT_VALUE
+    #define ARGUMENT_VALUE(name) \
+        (*arguments_get_##name())
+#endif
+
 /**
  * The type of the struct that contains all argument values.
  *
- * For every argument, a single struct is created containing
- *   * present: whether this argument was present on the command line
- *   * initialized: whether this argument has been initialised
+ * It contains only the parsed value of every argument, so that reading values
+ * touches as little memory as possible; the bookkeeping is kept in struct
+ * arguments_state_t.
+ */
+struct arguments_t {
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    name##_t name;
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#include "../arguments.def"
+};
+
+/**
+ * The number of bytes in a bit set with one bit for every argument.
+ */
+#define ARGUMENTS_BITS_SIZE \
+    (ARGUMENTS_COUNT / 8 + 1)
+
+/**
+ * Reads and sets the bit of an argument in a bit set.
+ *
+ * @param bits
+ *     The bit set.
+ * @param index
+ *     The index of the argument.
+ */
+#define arguments_bit_get(bits, index) \
+    (((bits)[(index) / 8] >> ((index) % 8)) & 1)
+#define arguments_bit_set(bits, index) \
+    ((bits)[(index) / 8] |= (unsigned char)(1 << ((index) % 8)))
+
+/**
+ * The command line values of an argument.
+ *
  *   * value_strings: the value passed for the argument on the command line, if
  *     any
  *   * value_strings_length: the number of string values in value_strings
- *   * value: its value after it has been parsed
  */
-struct arguments_t {
+struct arguments_strings_t {
+    char **value_strings;
+    unsigned int value_strings_length;
+};
+
+/**
+ * The type of the struct that contains the bookkeeping of all arguments,
+ * indexed by AI_name.
+ *
+ *   * present: a bit set of the arguments present on the command line, in the
+ *     environment or in a configuration file
+ *   * initialized: a bit set of the arguments that have been initialised
+ *   * loaded: if ARGUMENTS_SNAPSHOTS is non-zero, a bit set of the initialised
+ *     arguments whose values were loaded from the snapshot, and so are not
+ *     released
+ *   * sources: where the values of present arguments were found; one of the
+ *     AS_ constants
+ *   * command: the command selected on the command line, or ACMD_NONE
+ *   * once: if ARGUMENTS_LAZY is non-zero, the once flags guarding the
+ *     conversion of the values
+ *   * strings: the command line values of the arguments, which are only used
+ *     while converting the values
+ */
+struct arguments_state_t {
+    unsigned char present[ARGUMENTS_BITS_SIZE];
+    unsigned char initialized[ARGUMENTS_BITS_SIZE];
+#if ARGUMENTS_SNAPSHOTS && !ARGUMENTS_LAZY
+    unsigned char loaded[ARGUMENTS_BITS_SIZE];
+#endif
+    unsigned char sources[ARGUMENTS_COUNT + 1];
+    int command;
+#if ARGUMENTS_LAZY
+    int once[ARGUMENTS_COUNT + 1];
+#endif
+    struct arguments_strings_t strings[ARGUMENTS_COUNT + 1];
+};
+
+/**
+ * A range of consecutive command line arguments.
+ *
+ * The range covers argv[first] to argv[first + length - 1]; no strings are
+ * copied.
+ */
+struct arguments_range_t {
+    int first;
+    int length;
+};
+
+/**
+ * A list of ranges of command line arguments.
+ *
+ *   * ranges: the ranges, in the order they appear on the command line
+ *   * ranges_length: the number of elements in ranges
+ *   * ranges_size: the number of elements allocated for ranges
+ *   * count: the total number of command line arguments in all ranges
+ */
+struct arguments_ranges_t {
+    struct arguments_range_t *ranges;
+    unsigned int ranges_length;
+    unsigned int ranges_size;
+    unsigned int count;
+};
+
+/**
+ * The command line arguments that are not arguments or argument values.
+ *
+ * This is populated by arguments_scan.
+ *
+ *   * positional: the positional arguments; this includes everything
+ *     following "--"
+ *   * unknown: the command line arguments starting with "-" that do not match
+ *     any argument
+ */
+struct arguments_rest_t {
+    struct arguments_ranges_t positional;
+    struct arguments_ranges_t unknown;
+};
+
+#if ARGUMENTS_LAZY
+/**
+ * The accessors used by ARGUMENT_VALUE if ARGUMENTS_LAZY is non-zero.
+ *
+ * For every argument, the function name_t *arguments_get_name(void) is
+ * declared. It converts the value the first time it is called, and then
+ * returns a pointer to the value.
+ */
 #undef ARGUMENT
 #define ARGUMENT(type, name, short, help, value_count, is_required, \
         set_default, read, release) \
-    struct { \
-        int present; \
-        int initialized; \
-        char **value_strings; \
-        unsigned int value_strings_length; \
-        name##_t value; \
-    } name;
+    name##_t *arguments_get_##name(void);
 #undef ARGUMENT_SECTION
 #define ARGUMENT_SECTION(text)
 #include "../arguments.def"
-};
+#endif
 
 #ifdef ARGUMENTS_READ_ONLY
 extern struct arguments_t arguments;
+extern struct arguments_state_t arguments_state;
+extern struct arguments_rest_t arguments_rest;
 #else
 struct arguments_t arguments;
+struct arguments_state_t arguments_state;
+struct arguments_rest_t arguments_rest;
+#endif
+
+/**
+ * The values and bookkeeping read by ARGUMENT_VALUE and ARGUMENT_IS_PRESENT.
+ *
+ * While a context created with arguments_create_ctx is parsed, the readers see
+ * local variables with these names pointing into the context instead.
+ */
+static struct arguments_t *const ARGUMENTS_UNUSED arguments_current =
+    &arguments;
+static struct arguments_state_t *const ARGUMENTS_UNUSED
+    arguments_current_state = &arguments_state;
+
+#ifndef ARGUMENTS_READ_ONLY
 
 #if ARGUMENTS_AUTOMATIC
 
@@ -207,7 +462,9 @@ arguments_setup(int argc, char *argv[])
  * ARGUMENTS_AUTOMATIC is non-zero.
  *
  * Its function signature matches that of main with all arguments found in
- * arguments.def added to the argument list as well.
+ * arguments.def added to the argument list as well. If ARGUMENTS_LAZY is
+ * non-zero, the arguments are not added, since passing them would convert them;
+ * use ARGUMENT_VALUE instead.
  *
  * @param argc, argv
  *     The parameters passed to main.
@@ -217,9 +474,14 @@ arguments_setup(int argc, char *argv[])
  * @return the application return code
  */
 #undef ARGUMENT
+#if ARGUMENTS_LAZY
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release)
+#else
 #define ARGUMENT(type, name, short, help, value_count, is_required, \
         set_default, read, release) \
     , name##_t name
+#endif
 #undef ARGUMENT_SECTION
 #define ARGUMENT_SECTION(text)
 static int
@@ -245,243 +507,2194 @@ arguments_teardown(void)
 
 
 /**
- * Return values used by arguments_validate and arguments_parse.
+ * The names of all arguments, indexed by AI_name.
+ *
+ * long_length is the length of the long argument, which is the length of the
+ * name plus two for the leading "--".
  */
-enum {
-    /**
-     * The operation completed successfully.
-     */
-    AC_OK,
-
-    /**
-     * An invalid value was passed on the command line, or a required argument
-     * was missing.
-     */
-    AC_ERROR,
+static const struct {
+    const char *name;
+    unsigned int long_length;
+    const char *short_name;
+} arguments_descriptors[ARGUMENTS_COUNT + 1] = {
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    {#name, sizeof(#name) + 1, short},
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#include "../arguments.def"
+    {NULL, 0, NULL}
+};
 
-    /**
-     * The command line argument --help was found, and the help message was
-     * printed.
-     *
-     * Unless ARGUMENTS_PRINT_HELP is non-zero, this value will not be returned.
-     */
-    AC_HELP
+#if defined(__cplusplus) && (__cplusplus >= 201402L)
+/**
+ * The names of all arguments as a constant expression, indexed by AI_name.
+ *
+ * When compiling as C++14 or later, this table lets the header width be
+ * computed and conflicting names be detected at compile time.
+ */
+struct arguments_static_name_t {
+    const char *name;
+    const char *short_name;
+};
+static constexpr arguments_static_name_t
+        arguments_static_names[ARGUMENTS_COUNT + 1] = {
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    {#name, short},
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#include "../arguments.def"
+    {nullptr, nullptr}
 };
 
+/**
+ * The arguments and commands in the order they are defined, as a constant
+ * expression; every argument is represented by AI_name, every command by -1,
+ * and the table is terminated by ARGUMENTS_COUNT.
+ */
+static constexpr int arguments_static_groups[] = {
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    AI_##name,
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help) \
+    -1,
+#include "../arguments.def"
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help)
+    ARGUMENTS_COUNT
+};
 
 /**
- * Compares a long argument to a name string.
- *
- * The first two characters of longarg must be "--".
- *
- * @param longarg
- *     The long argument.
- * @param name
- *     The name of the argument.
- * @return 0 if longarg is the long argument for name, non-zero otherwise
+ * Returns the command of an argument at compile time, or ACMD_NONE if it is
+ * global.
  */
-static int
-arguments_cmp(const char *longarg, const char *name)
+static constexpr int
+arguments_static_command(int index)
 {
-    /* Skip the first two characters */
-    if (*(longarg++) != '-') return -1;
-    if (*(longarg++) != '-') return -1;
+    int result = ACMD_NONE;
 
-    /* Compare the rest of the characters one by one, converting '_' in name to
-       '-' */
-    while (*longarg && *name) {
-        if (*longarg != (*name == '_' ? '-' : *name)) {
-            break;
+    for (int i = 0; arguments_static_groups[i] != index; i++) {
+        if (arguments_static_groups[i] < 0) {
+            result++;
         }
-        longarg++;
-        name++;
     }
 
-    return *longarg - ((*name == '_') ? '-' : *name);
+    return result;
 }
 
-
 /**
- * Initialises the arguments struct by zeroing it.
- *
- * Unless ARGUMENTS_AUTOMATIC is non-zero, this should be called before calling
- * arguments_parse.
+ * Returns the length of a string at compile time.
  */
-static void
-arguments_initialize(void)
+static constexpr unsigned int
+arguments_static_length(const char *s)
 {
-    memset(&arguments, 0, sizeof(arguments));
-}
-
+    unsigned int result = 0;
 
-#if ARGUMENTS_PRINT_HELP
-    #include "arguments-help.h"
-#endif
+    while (s[result]) {
+        result++;
+    }
 
+    return result;
+}
 
 /**
- * Releases all arguments that have been initialised.
+ * Determines whether a short name equals a command line argument at compile
+ * time.
  *
- * If arguments_set has been called, this function must also be called, even if
- * arguments_set returned an error.
+ * @param short_name
+ *     The short name.
+ * @param prefix
+ *     The first part of the command line argument.
+ * @param name
+ *     The rest of the command line argument, where an underscore matches a
+ *     dash.
  */
-static void
-arguments_release(void)
+static constexpr bool
+arguments_static_equal(const char *short_name, const char *prefix,
+    const char *name)
 {
-#undef ARGUMENT
-#define ARGUMENT(type, name, short, help, value_count, is_required, \
-        set_default, read, release) \
-    if (arguments.name.initialized) { \
-        name##_t *target = &arguments.name.value; \
-        \
-        do { \
-            release \
-        } while (0); \
-        \
-        if (target); \
+    while (*prefix) {
+        if (*(short_name++) != *(prefix++)) {
+            return false;
+        }
     }
-#undef ARGUMENT_SECTION
-#define ARGUMENT_SECTION(text)
-#include "../arguments.def"
+    for (; *name; name++, short_name++) {
+        if (*short_name != ((*name == '_') ? '-' : *name)) {
+            return false;
+        }
+    }
+
+    return !*short_name;
 }
 
+/**
+ * Returns the width of the argument names header at compile time; see
+ * argument_header_width.
+ */
+static constexpr unsigned int
+arguments_static_header_width(void)
+{
+    unsigned int result = 0;
+
+    for (int i = 0; i < ARGUMENTS_COUNT; i++) {
+        const char *short_name = arguments_static_names[i].short_name;
+        unsigned int current =
+            arguments_static_length(arguments_static_names[i].name) + 2;
+
+        if (short_name) {
+            current += 2 + arguments_static_length(short_name);
+        }
+        if (current > result) {
+            result = current;
+        }
+    }
+
+    return result;
+}
 
 /**
- * Parses the command line given by argv and argc.
+ * Determines whether the short name of an argument can never be matched at
+ * compile time.
+ *
+ * This is the case if it equals the short name of an earlier argument, the
+ * long argument of any argument, or --help or -h if ARGUMENTS_PRINT_HELP is
+ * non-zero. Arguments of different commands never shadow each other.
+ *
+ * @param index
+ *     The index of the argument.
+ */
+static constexpr bool
+arguments_static_is_shadowed(int index)
+{
+    const char *short_name = arguments_static_names[index].short_name;
+    const int command = arguments_static_command(index);
+    int current = ACMD_NONE;
+
+    if (!short_name || !*short_name) {
+        return false;
+    }
+#if ARGUMENTS_PRINT_HELP
+    else if (arguments_static_equal(short_name, "--help", "")
+            || arguments_static_equal(short_name, "-h", "")) {
+        return true;
+    }
+#endif
+
+    /* The arguments are walked in the order they are defined, so that the
+       command of every argument is known */
+    for (int g = 0; arguments_static_groups[g] != ARGUMENTS_COUNT; g++) {
+        const int i = arguments_static_groups[g];
+        const char *other = (i >= 0) ? arguments_static_names[i].short_name
+            : nullptr;
+
+        if (i < 0) {
+            current++;
+        }
+        else if ((command != ACMD_NONE) && (current != ACMD_NONE)
+                && (current != command)) {
+            continue;
+        }
+        else if (((i < index) && other
+                    && arguments_static_equal(short_name, other, ""))
+                || arguments_static_equal(short_name, "--",
+                    arguments_static_names[i].name)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Determines whether any short name can never be matched at compile time.
+ */
+static constexpr bool
+arguments_static_has_shadowed(void)
+{
+    for (int i = 0; i < ARGUMENTS_COUNT; i++) {
+        if (arguments_static_is_shadowed(i)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static_assert(!arguments_static_has_shadowed(),
+    "a short name in arguments.def is used twice, equals a long argument or "
+    "equals --help or -h");
+#endif
+
+/**
+ * The size of the buffer containing all long arguments, including their
+ * terminating NUL characters.
+ */
+enum {
+    ARGUMENTS_LONG_NAMES_SIZE = 1
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    + sizeof("--" #name)
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#include "../arguments.def"
+};
+
+/**
+ * The buffer containing all long arguments.
+ */
+static char arguments_long_names_buffer[ARGUMENTS_LONG_NAMES_SIZE];
+
+/**
+ * The long arguments, indexed by AI_name.
+ *
+ * Every long argument is the name of the argument prepended by "--" and with
+ * all underscores replaced with dashes. The length of every long argument is
+ * found in arguments_descriptors. It is populated by arguments_prepare.
+ */
+static const char *arguments_long_names[ARGUMENTS_COUNT + 1];
+
+/**
+ * Determines whether a command line argument is the long argument of an
+ * argument.
+ *
+ * @param arg
+ *     The command line argument.
+ * @param length
+ *     The length of arg.
+ * @param index
+ *     The index of the argument.
+ */
+#define arguments_is_long_name(arg, length, index) \
+    (((length) == arguments_descriptors[index].long_length) \
+        && (memcmp((arg), arguments_long_names[index], (length)) == 0))
+
+
+#if ARGUMENTS_DISPATCH_HASH
+
+/**
+ * The number of slots in the long argument hash table.
+ *
+ * There are always more than twice as many slots as arguments, so a lookup
+ * will only have to probe a few slots.
+ */
+#define ARGUMENTS_HASH_SIZE (2 * ARGUMENTS_COUNT + 1)
+
+/**
+ * The long argument hash table.
+ *
+ * Every slot contains the index of an argument plus one, or 0 if the slot is
+ * empty. It is populated by arguments_prepare.
+ */
+static int arguments_hash_table[ARGUMENTS_HASH_SIZE];
+
+/**
+ * Calculates the hash of a long argument.
+ *
+ * @param arg
+ *     The long argument to hash.
+ * @param length
+ *     The length of arg.
+ * @return the hash of arg
+ */
+static unsigned int
+arguments_hash(const char *arg, unsigned int length)
+{
+    unsigned int result = 2166136261u;
+
+    while (length--) {
+        result ^= (unsigned char)*(arg++);
+        result *= 16777619u;
+    }
+
+    return result;
+}
+
+#endif
+
+
+#if ARGUMENTS_ABBREVIATIONS || defined(ARGUMENTS_COMPLETE)
+
+/**
+ * The indices of all arguments, ordered by their long arguments, so that the
+ * arguments whose long arguments start with a prefix are consecutive. It is
+ * populated by arguments_prepare.
+ */
+static int arguments_sorted[ARGUMENTS_COUNT + 1];
+
+/**
+ * Compares the long arguments of two arguments for qsort.
+ *
+ * @param a, b
+ *     Pointers to the indices of the arguments.
+ */
+static int
+arguments_sorted_compare(const void *a, const void *b)
+{
+    return strcmp(arguments_long_names[*(const int*)a],
+        arguments_long_names[*(const int*)b]);
+}
+
+/**
+ * Finds the arguments whose long arguments start with a prefix.
+ *
+ * The arguments are found with two binary searches in arguments_sorted.
+ *
+ * @param prefix
+ *     The prefix, including the leading "--". It need not be terminated.
+ * @param length
+ *     The length of prefix.
+ * @param count
+ *     The number of arguments found is written to this variable.
+ * @return the position in arguments_sorted of the first argument found
+ */
+static int
+arguments_lookup_prefix(const char *prefix, size_t length, int *count)
+{
+    int first = 0, last = ARGUMENTS_COUNT, end;
+
+    /* Find the first long argument not ordered before the prefix */
+    while (first < last) {
+        int middle = first + (last - first) / 2;
+
+        if (strncmp(arguments_long_names[arguments_sorted[middle]], prefix,
+                length) < 0) {
+            first = middle + 1;
+        }
+        else {
+            last = middle;
+        }
+    }
+
+    /* Find the first long argument following it that does not start with the
+       prefix */
+    end = first;
+    last = ARGUMENTS_COUNT;
+    while (end < last) {
+        int middle = end + (last - end) / 2;
+
+        if (strncmp(arguments_long_names[arguments_sorted[middle]], prefix,
+                length) == 0) {
+            end = middle + 1;
+        }
+        else {
+            last = middle;
+        }
+    }
+
+    *count = end - first;
+
+    return first;
+}
+
+#endif
+
+
+/**
+ * The size of the buffer containing the command line arguments of all
+ * commands, including their terminating NUL characters.
+ */
+enum {
+    ARGUMENTS_COMMAND_NAMES_SIZE = 1
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release)
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help) \
+    + sizeof(#name)
+#include "../arguments.def"
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help)
+};
+
+/**
+ * The buffer containing the command line arguments of all commands.
+ */
+static char arguments_command_names_buffer[ARGUMENTS_COMMAND_NAMES_SIZE];
+
+/**
+ * The command line arguments selecting the commands, indexed by ACMD_name.
+ *
+ * Every command line argument is the name of the command with all underscores
+ * replaced with dashes; the entry for ACMD_NONE is NULL. It is populated by
+ * arguments_prepare.
+ */
+static const char *arguments_command_names[ARGUMENTS_COMMAND_COUNT];
+
+/**
+ * The index of the first argument of every command, indexed by ACMD_name.
+ *
+ * The arguments of a command are defined consecutively, so the arguments of
+ * the command c are those from arguments_command_first[c] up to, but not
+ * including, arguments_command_first[c + 1]; the global arguments are those
+ * of ACMD_NONE. It is populated by arguments_prepare.
+ */
+static int arguments_command_first[ARGUMENTS_COMMAND_COUNT + 1];
+
+/**
+ * The command of every argument, or ACMD_NONE for global arguments, indexed by
+ * AI_name. It is populated by arguments_prepare.
+ */
+static int arguments_command_of[ARGUMENTS_COUNT + 1];
+
+/**
+ * Determines whether an argument is matched, converted and released when a
+ * command has been selected, which is the case if it is global or belongs to
+ * the command.
+ *
+ * @param index
+ *     The index of the argument.
+ * @param command
+ *     The selected command, or ACMD_NONE.
+ */
+#define arguments_is_visible(index, command) \
+    ((arguments_command_of[index] == ACMD_NONE) \
+        || (arguments_command_of[index] == (command)))
+
+/**
+ * The single character short argument tables, indexed by ACMD_name.
+ *
+ * For every short argument on the form "-c" of a global argument or an
+ * argument of the command, the entry for c contains the index of the argument
+ * plus one. All other entries are 0. They are populated by arguments_prepare.
+ */
+static int arguments_short_table[ARGUMENTS_COMMAND_COUNT][256];
+
+/**
+ * The indices of the arguments with a short argument that does not fit in
+ * arguments_short_table, terminated by -1. It is populated by
+ * arguments_prepare.
+ */
+static int arguments_short_others[ARGUMENTS_COUNT + 1];
+
+/**
+ * The flags of the arguments, indexed by AI_name. It is populated by
+ * arguments_prepare from the ARGUMENT_FLAGS invocations in arguments.def.
+ */
+static unsigned int arguments_flags[ARGUMENTS_COUNT + 1];
+
+/**
+ * The number of arguments with the flag ARGUMENT_ACCUMULATE.
+ */
+static int arguments_accumulating;
+
+/**
+ * Determines whether a command line argument is on the form "-c".
+ */
+#define arguments_is_short_char(arg) \
+    (((arg)[0] == '-') && (arg)[1] && ((arg)[1] != '-') && !(arg)[2])
+
+
+#include "arguments-thread.h"
+
+/**
+ * Prepares the lookup tables used by arguments_lookup.
+ *
+ * This function is called by arguments_initialize and arguments_create_ctx;
+ * it only performs any work the first time it is called. The tables are
+ * prepared under a once flag, so threads creating their first contexts at
+ * the same time wait for one of them to prepare the tables, which are never
+ * modified afterwards.
+ */
+static void
+arguments_prepare(void)
+{
+    static int once = AO_NONE;
+    char *long_name;
+    int i, command, others;
+
+    if (!arguments_once_begin(&once)) {
+        return;
+    }
+
+    /* Generate the long arguments once */
+    long_name = arguments_long_names_buffer;
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        const char *c;
+
+        arguments_long_names[i] = long_name;
+        *(long_name++) = '-';
+        *(long_name++) = '-';
+        for (c = arguments_descriptors[i].name; *c; c++) {
+            *(long_name++) = (*c == '_') ? '-' : *c;
+        }
+        *(long_name++) = '\0';
+    }
+
+    /* Find the arguments of every command */
+    i = 0;
+    command = ACMD_NONE;
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    arguments_command_of[i++] = command;
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help) \
+    command = ACMD_##name; \
+    arguments_command_first[command] = i; \
+    arguments_command_names[command] = #name;
+#include "../arguments.def"
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help)
+    arguments_command_first[ARGUMENTS_COMMAND_COUNT] = ARGUMENTS_COUNT;
+
+    /* Generate the command line arguments of the commands once */
+    long_name = arguments_command_names_buffer;
+    for (command = ACMD_NONE + 1; command < ARGUMENTS_COMMAND_COUNT;
+            command++) {
+        const char *c = arguments_command_names[command];
+
+        arguments_command_names[command] = long_name;
+        for (; *c; c++) {
+            *(long_name++) = (*c == '_') ? '-' : *c;
+        }
+        *(long_name++) = '\0';
+    }
+
+#if ARGUMENTS_DISPATCH_HASH
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        unsigned int slot = arguments_hash(arguments_long_names[i],
+            arguments_descriptors[i].long_length) % ARGUMENTS_HASH_SIZE;
+
+        /* Use linear probing to find a free slot */
+        while (arguments_hash_table[slot]) {
+            slot = (slot + 1) % ARGUMENTS_HASH_SIZE;
+        }
+        arguments_hash_table[slot] = i + 1;
+    }
+#endif
+
+#if ARGUMENTS_ABBREVIATIONS || defined(ARGUMENTS_COMPLETE)
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        arguments_sorted[i] = i;
+    }
+    qsort(arguments_sorted, ARGUMENTS_COUNT, sizeof(*arguments_sorted),
+        arguments_sorted_compare);
+#endif
+
+    others = 0;
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        const char *short_name = arguments_descriptors[i].short_name;
+
+        if (!short_name || !*short_name) {
+            continue;
+        }
+        else if (arguments_is_short_char(short_name)) {
+            /* The first argument with a short name takes precedence; global
+               arguments are entered in the tables of all commands */
+            for (command = ACMD_NONE; command < ARGUMENTS_COMMAND_COUNT;
+                    command++) {
+                int *entry = &arguments_short_table[command][
+                    (unsigned char)short_name[1]];
+
+                if (!*entry && arguments_is_visible(i, command)) {
+                    *entry = i + 1;
+                }
+            }
+        }
+        else {
+            arguments_short_others[others++] = i;
+        }
+    }
+    arguments_short_others[others] = -1;
+
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release)
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#undef ARGUMENT_FLAGS
+#define ARGUMENT_FLAGS(name, flags) \
+    arguments_flags[AI_##name] |= (flags);
+#include "../arguments.def"
+#undef ARGUMENT_FLAGS
+#define ARGUMENT_FLAGS(name, flags)
+
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        if (arguments_flags[i] & ARGUMENT_ACCUMULATE) {
+            arguments_accumulating++;
+        }
+    }
+
+    arguments_once_end(&once);
+}
+
+
+/**
+ * Finds the argument matching a long argument.
+ *
+ * @param arg
+ *     The long argument, including the leading "--". It need not be
+ *     terminated.
+ * @param length
+ *     The length of arg.
+ * @param command
+ *     The selected command; only global arguments and those of this command
+ *     are matched.
+ * @return the index of the argument, or -1 if arg does not match any argument
+ */
+static int
+arguments_lookup_long(const char *arg, unsigned int length, int command)
+{
+    int i;
+#if ARGUMENTS_DISPATCH_HASH
+    /* Long arguments are found in the hash table */
+    unsigned int slot = arguments_hash(arg, length) % ARGUMENTS_HASH_SIZE;
+
+    while (arguments_hash_table[slot]) {
+        i = arguments_hash_table[slot] - 1;
+        if (arguments_is_long_name(arg, length, i)) {
+            return arguments_is_visible(i, command) ? i : -1;
+        }
+        slot = (slot + 1) % ARGUMENTS_HASH_SIZE;
+    }
+#else
+    /* Only the global arguments and those of the command are compared */
+    for (i = 0; i < arguments_command_first[ACMD_NONE + 1]; i++) {
+        if (arguments_is_long_name(arg, length, i)) {
+            return i;
+        }
+    }
+    if (command != ACMD_NONE) {
+        for (i = arguments_command_first[command];
+                i < arguments_command_first[command + 1]; i++) {
+            if (arguments_is_long_name(arg, length, i)) {
+                return i;
+            }
+        }
+    }
+#endif
+
+    return -1;
+}
+
+/**
+ * A buffer large enough to hold the long argument of any argument.
+ */
+union arguments_long_name_t {
+    char empty[sizeof("--")];
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    char name[sizeof("--" #name)];
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#include "../arguments.def"
+};
+
+/**
+ * Finds the argument with a name, as used in the environment and in
+ * configuration files.
+ *
+ * Dashes and underscores in name are equivalent.
+ *
+ * @param name
+ *     The name. It need not be terminated.
+ * @param length
+ *     The length of name.
+ * @param is_upper
+ *     Whether the name is in upper case, for example "VERBOSE_LEVEL" for the
+ *     argument verbose_level.
+ * @param command
+ *     The selected command.
+ * @return the index of the argument, or -1 if name does not match any argument
+ */
+static ARGUMENTS_UNUSED int
+arguments_lookup_name(const char *name, size_t length, int is_upper,
+    int command)
+{
+    union arguments_long_name_t long_name;
+    char *buffer = (char*)&long_name;
+    size_t i;
+
+    /* Names too long for any argument cannot match */
+    if (length > sizeof(long_name) - 2) {
+        return -1;
+    }
+
+    buffer[0] = '-';
+    buffer[1] = '-';
+    for (i = 0; i < length; i++) {
+        char c = name[i];
+
+        if (c == '_') {
+            c = '-';
+        }
+        else if (is_upper && (c >= 'A') && (c <= 'Z')) {
+            c = (char)(c - 'A' + 'a');
+        }
+        buffer[i + 2] = c;
+    }
+
+    return arguments_lookup_long(buffer, (unsigned int)length + 2, command);
+}
+
+#if ARGUMENTS_ABBREVIATIONS
+/**
+ * Finds the argument whose long argument starts with a command line argument,
+ * provided that there is only one.
+ *
+ * @param arg
+ *     The command line argument, including the leading "--".
+ * @param length
+ *     The length of arg.
+ * @param command
+ *     The selected command; only global arguments and those of this command
+ *     are matched.
+ * @return the index of the argument, or -1 if arg is not a prefix of exactly
+ *     one long argument
+ */
+static int
+arguments_lookup_abbreviation(const char *arg, size_t length, int command)
+{
+    int position, count, result = -1;
+
+    for (position = arguments_lookup_prefix(arg, length, &count); count--;
+            position++) {
+        if (arguments_is_visible(arguments_sorted[position], command)) {
+            if (result >= 0) {
+                return -1;
+            }
+            result = arguments_sorted[position];
+        }
+    }
+
+    return result;
+}
+#endif
+
+/**
+ * Finds the argument matching a command line argument.
+ *
+ * @param arg
+ *     The command line argument.
+ * @param command
+ *     The selected command; only global arguments and those of this command
+ *     are matched.
+ * @return the index of the argument, or -1 if arg does not match any argument
+ */
+static int
+arguments_lookup(const char *arg, int command)
+{
+    int i;
+
+    /* Single character short arguments are found in the short table */
+    if (arguments_is_short_char(arg)) {
+        return arguments_short_table[command][(unsigned char)arg[1]] - 1;
+    }
+
+    if ((arg[0] == '-') && (arg[1] == '-')) {
+        i = arguments_lookup_long(arg, strlen(arg), command);
+        if (i >= 0) {
+            return i;
+        }
+    }
+
+    /* Any other short arguments are compared one by one */
+    for (i = 0; arguments_short_others[i] >= 0; i++) {
+        if (arguments_is_visible(arguments_short_others[i], command)
+                && (strcmp(arg, arguments_descriptors[
+                    arguments_short_others[i]].short_name) == 0)) {
+            return arguments_short_others[i];
+        }
+    }
+
+#if ARGUMENTS_ABBREVIATIONS
+    /* An unambiguous prefix of a long argument matches it; "--" alone is not
+       an abbreviation */
+    if ((arg[0] == '-') && (arg[1] == '-') && arg[2]) {
+        return arguments_lookup_abbreviation(arg, strlen(arg), command);
+    }
+#endif
+
+    return -1;
+}
+
+/**
+ * Finds the command selected by a command line argument.
+ *
+ * @param arg
+ *     The command line argument.
+ * @return the index of the command, or ACMD_NONE if arg does not match any
+ *     command
+ */
+static int
+arguments_lookup_command(const char *arg)
+{
+    int i;
+
+    for (i = ACMD_NONE + 1; i < ARGUMENTS_COMMAND_COUNT; i++) {
+        if (strcmp(arg, arguments_command_names[i]) == 0) {
+            return i;
+        }
+    }
+
+    return ACMD_NONE;
+}
+
+
+#if ARGUMENTS_SHORT_BUNDLES
+
+/**
+ * Determines whether a command line argument is a bundle of single character
+ * short arguments, such as -abc.
+ *
+ * @param arg
+ *     The command line argument.
+ * @param command
+ *     The selected command.
+ * @return non-zero if every character following the leading dash is a single
+ *     character short argument, or 0 otherwise
+ */
+static int
+arguments_is_bundle(const char *arg, int command)
+{
+    if ((arg[0] != '-') || !arg[1] || (arg[1] == '-')) {
+        return 0;
+    }
+
+    for (arg++; *arg; arg++) {
+        if (!arguments_short_table[command][(unsigned char)*arg]) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+#endif
+
+
+/**
+ * Initialises the arguments struct by zeroing it.
+ *
+ * Unless ARGUMENTS_AUTOMATIC is non-zero, this should be called before calling
+ * arguments_parse.
+ */
+static void
+arguments_initialize(void)
+{
+    memset(&arguments, 0, sizeof(arguments));
+    memset(&arguments_state, 0, sizeof(arguments_state));
+    memset(&arguments_rest, 0, sizeof(arguments_rest));
+    arguments_prepare();
+}
+
+
+#if ARGUMENTS_PRINT_HELP
+    #include "arguments-help.h"
+#endif
+
+#if ARGUMENTS_RESPONSE_FILES
+    #include "arguments-response.h"
+#endif
+
+#if defined(WIN32)
+    #include "arguments-windows.h"
+#endif
+
+/**
+ * Reads and sets the bit of an argument in a bit set that may be modified by
+ * several threads at once.
+ */
+#if ARGUMENTS_LAZY || ARGUMENTS_PARALLEL
+    #define arguments_bit_get_shared(bits, index) \
+        ((arguments_atomic_load_byte(&(bits)[(index) / 8]) \
+            >> ((index) % 8)) & 1)
+    #define arguments_bit_set_shared(bits, index) \
+        arguments_atomic_or_byte(&(bits)[(index) / 8], \
+            (unsigned char)(1 << ((index) % 8)))
+#else
+    #define arguments_bit_get_shared(bits, index) \
+        arguments_bit_get(bits, index)
+    #define arguments_bit_set_shared(bits, index) \
+        arguments_bit_set(bits, index)
+#endif
+
+#include "arguments-arena.h"
+
+#if ARGUMENTS_READERS
+    #include "arguments-readers.h"
+#endif
+
+#if ARGUMENTS_PROFILE
+    #include "arguments-profile.h"
+#else
+    #define ARGUMENTS_PROFILE_START
+    #define ARGUMENTS_PROFILE_STOP(target)
+#endif
+
+/**
+ * Converts the expansion of a block to a string, so that empty blocks can be
+ * recognised.
+ */
+#define ARGUMENTS_STRINGIFY(block) \
+    #block
+#define ARGUMENTS_EXPAND_STRINGIFY(block) \
+    ARGUMENTS_STRINGIFY(block)
+
+/**
+ * Whether the release block of every argument is non-empty, indexed by
+ * AI_name.
+ */
+static const unsigned char arguments_has_release[ARGUMENTS_COUNT + 1] = {
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    sizeof(ARGUMENTS_EXPAND_STRINGIFY(release)) > 1,
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#include "../arguments.def"
+    0
+};
+
+/**
+ * Determines whether an argument must be released when the process
+ * terminates, given its flags.
+ *
+ * @param index
+ *     The index of the argument.
+ */
+#if ARGUMENTS_LEAK_CHECK
+    #define arguments_is_released_at_exit(index) \
+        (arguments_has_release[index] \
+            && !(arguments_flags[index] & ARGUMENT_NO_RELEASE))
+#else
+    #define arguments_is_released_at_exit(index) \
+        (arguments_has_release[index] \
+            && !(arguments_flags[index] \
+                & (ARGUMENT_NO_RELEASE | ARGUMENT_DEBUG_RELEASE)))
+#endif
+
+
+/**
+ * The passes over the command line used by arguments_read and arguments_scan.
+ */
+enum {
+    /**
+     * Arguments are read; the values of an argument replace any values read
+     * for a previous occurrence.
+     */
+    AP_READ,
+
+    /**
+     * Nothing is read; the values of arguments with the flag
+     * ARGUMENT_ACCUMULATE are only counted.
+     */
+    AP_COUNT,
+
+    /**
+     * Arguments are read; the values of arguments with the flag
+     * ARGUMENT_ACCUMULATE are appended to the storage allocated after an
+     * AP_COUNT pass.
+     */
+    AP_ACCUMULATE
+};
+
+/**
+ * Determines whether a command line argument looks like an argument.
+ */
+#define arguments_is_option(arg) \
+    (((arg)[0] == '-') && (arg)[1])
+
+/**
+ * Calculates the number of values to read for an argument.
+ *
+ * @param index
+ *     The index of the argument.
+ * @param argc, argv
+ *     The command line.
+ * @param position
+ *     The index of the first value of the argument.
+ * @return the number of values, or -1 if not enough values were passed
+ */
+static int
+arguments_value_count(int index, int argc, char *argv[], int position)
+{
+    int count;
+
+    switch (index) {
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    case AI_##name: \
+        count = (int)(value_count); \
+        break;
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#include "../arguments.def"
+
+    default:
+        return -1;
+    }
+
+    if (count == ARGUMENT_VARIADIC) {
+        for (count = 0; position + count < argc; count++) {
+            if (arguments_is_option(argv[position + count])) {
+                break;
+            }
+        }
+    }
+
+    return (position + count <= argc) ? count : -1;
+}
+
+/**
+ * The storage used while parsing a command line.
+ *
+ * The global variables are parsed with arguments_context; other contexts are
+ * created with arguments_create_ctx.
+ *
+ *   * values: the parsed argument values
+ *   * state: the bookkeeping of the arguments
+ *   * rest: the command line arguments that are not arguments or values
+ *   * accumulated: the storage for the values of all arguments with the flag
+ *     ARGUMENT_ACCUMULATE
+ *   * argv: the command line converted by arguments_parse_wide_ctx
+ *   * config_path: the configuration file read by arguments_scan_ctx, or NULL
+ *   * config, config_size: the mapping of the configuration file, to which
+ *     the values read from it refer
+ *   * snapshot, snapshot_size: the snapshot loaded by arguments_set_ctx, or
+ *     NULL
+ *   * is_snapshot_mapped: whether snapshot was mapped by
+ *     arguments_map_snapshot, and is unmapped when the context is released
+ *   * arena: the arena passed to readers
+ *   * profile: the time spent in the blocks of arguments.def, if
+ *     ARGUMENTS_PROFILE is non-zero
+ *   * responses: the response files expanded by arguments_scan_ctx, if
+ *     ARGUMENTS_RESPONSE_FILES is non-zero; if responses.argv is not NULL,
+ *     the ranges of rest refer to it instead of the command line scanned
+ */
+struct arguments_context_t {
+    struct arguments_t *values;
+    struct arguments_state_t *state;
+    struct arguments_rest_t *rest;
+    char **accumulated;
+    char **argv;
+    const char *config_path;
+    char *config;
+    size_t config_size;
+    char *snapshot;
+    size_t snapshot_size;
+    int is_snapshot_mapped;
+    struct arguments_arena_t arena;
+#if ARGUMENTS_PROFILE
+    struct arguments_profile_t profile;
+#endif
+#if ARGUMENTS_RESPONSE_FILES
+    struct arguments_responses_t responses;
+#endif
+};
+
+/**
+ * The context of the global variables arguments, arguments_state and
+ * arguments_rest.
+ */
+static struct arguments_context_t arguments_context = {
+    &arguments, &arguments_state, &arguments_rest, NULL, NULL,
+    ARGUMENTS_CONFIG_FILE, NULL, 0, NULL, 0, 0, {NULL, 0}
+#if ARGUMENTS_PROFILE
+    , {{0}, {0}, 0, 0}
+#endif
+#if ARGUMENTS_RESPONSE_FILES
+    , {NULL, 0, 0, NULL}
+#endif
+};
+
+#if ARGUMENTS_RESPONSE_FILES
+/**
+ * Expands response files on the command line for arguments_read.
+ *
+ * arguments_scan and arguments_parse_ctx expand response files themselves, so
+ * this is only needed when parsing the command line with arguments_read. The
+ * expanded command line remains valid until arguments_release is called.
+ *
+ * See arguments_response_expand for a description of the parameters and the
+ * return value.
+ */
+static ARGUMENTS_UNUSED int
+arguments_expand(int *argc, char ***argv)
+{
+    return arguments_response_expand(&arguments_context.responses, argc,
+        argv);
+}
+#endif
+
+
+#if ARGUMENTS_CONFIG_FILES
+    #include "arguments-config.h"
+#endif
+
+#if ARGUMENTS_SNAPSHOTS && !ARGUMENTS_LAZY
+    #include "arguments-snapshot.h"
+#endif
+
+
+/**
+ * Releases all arguments of a context that have been initialised, except those
+ * loaded from a snapshot, since their values refer to the snapshot.
+ *
+ * @param ctx
+ *     The context.
+ * @param is_exiting
+ *     Whether the process is terminating. If this is non-zero, only the
+ *     arguments for which arguments_is_released_at_exit holds are released.
+ */
+#if ARGUMENTS_SNAPSHOTS && !ARGUMENTS_LAZY
+    #define arguments_is_loaded(ctx, index) \
+        arguments_bit_get((ctx)->state->loaded, index)
+#else
+    #define arguments_is_loaded(ctx, index) 0
+#endif
+static void
+arguments_release_values(struct arguments_context_t *ctx, int is_exiting)
+{
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    if (arguments_bit_get(ctx->state->initialized, AI_##name) \
+            && !arguments_is_loaded(ctx, AI_##name) \
+            && (!is_exiting || arguments_is_released_at_exit(AI_##name))) { \
+        name##_t *target = &ctx->values->name; \
+        ARGUMENTS_PROFILE_START \
+        \
+        do { \
+            release \
+        } while (0); \
+        \
+        ARGUMENTS_PROFILE_STOP(ctx->profile.released[AI_##name]) \
+        if (target); \
+    }
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#include "../arguments.def"
+}
+
+/**
+ * Frees the memory allocated from the arena of a context, and the ranges and
+ * accumulated values collected while scanning.
+ *
+ * @param ctx
+ *     The context.
+ */
+static void
+arguments_release_storage(struct arguments_context_t *ctx)
+{
+    arguments_arena_release(&ctx->arena);
+
+    free(ctx->rest->positional.ranges);
+    free(ctx->rest->unknown.ranges);
+    memset(ctx->rest, 0, sizeof(*ctx->rest));
+
+    free(ctx->accumulated);
+    ctx->accumulated = NULL;
+
+    free(ctx->argv);
+    ctx->argv = NULL;
+
+#if ARGUMENTS_CONFIG_FILES
+    arguments_config_unmap(ctx);
+#endif
+
+#if ARGUMENTS_SNAPSHOTS && !ARGUMENTS_LAZY
+    arguments_unmap_snapshot(ctx);
+#endif
+
+#if ARGUMENTS_RESPONSE_FILES
+    arguments_response_release(&ctx->responses);
+#endif
+}
+
+/**
+ * Releases all arguments that have been initialised, the memory allocated
+ * from the arena, the ranges and accumulated values collected by
+ * arguments_scan and any response files it expanded.
+ *
+ * If arguments_set has been called, this function must also be called, even if
+ * arguments_set returned an error. Since it is meant to be called when the
+ * process terminates, arguments with the flag ARGUMENT_NO_RELEASE, and unless
+ * ARGUMENTS_LEAK_CHECK is non-zero those with the flag ARGUMENT_DEBUG_RELEASE,
+ * are not released.
+ */
+static void
+arguments_release(void)
+{
+    arguments_release_values(&arguments_context, 1);
+    arguments_release_storage(&arguments_context);
+}
+
+
+/**
+ * Marks an argument as present and assigns its values from the command line.
+ *
+ * @param ctx
+ *     The context.
+ * @param index
+ *     The index of the argument.
+ * @param argc, argv
+ *     The command line.
+ * @param position
+ *     The index of the first value of the argument. Upon successful return,
+ *     this will contain the index following the last value.
+ * @param pass
+ *     The current pass over the command line.
+ * @return non-zero if enough values were passed for the argument, or 0
+ *     otherwise
+ */
+static int
+arguments_take(struct arguments_context_t *ctx, int index, int argc,
+    char *argv[], int *position, int pass)
+{
+    int count = arguments_value_count(index, argc, argv, *position);
+    int accumulate = (pass != AP_READ)
+        && (arguments_flags[index] & ARGUMENT_ACCUMULATE);
+    struct arguments_strings_t *strings = &ctx->state->strings[index];
+
+    if (pass != AP_COUNT) {
+        arguments_bit_set(ctx->state->present, index);
+        ctx->state->sources[index] = AS_COMMAND_LINE;
+    }
+
+    if (count < 0) {
+        return 0;
+    }
+    else if (!accumulate) {
+        if (pass != AP_COUNT) {
+            strings->value_strings = argv + *position;
+            strings->value_strings_length = count;
+        }
+    }
+    else {
+        if ((pass == AP_ACCUMULATE) && (count > 0)) {
+            memcpy(strings->value_strings + strings->value_strings_length,
+                argv + *position, count * sizeof(*argv));
+        }
+        strings->value_strings_length += count;
+    }
+
+    *position += count;
+
+    return 1;
+}
+
+
+/**
+ * Performs a pass over the command line given by argv and argc.
+ *
+ * This function will parse the arguments from argv[*nextarg] until either the
+ * end of argv is reached, a command line argument that does not match any
+ * argument is encountered or an invalid argument value is encountered.
+ *
+ * If ARGUMENTS_PRINT_HELP is non-zero, this function will print a help message
+ * if the arguments --help or -h are encountered. If ARGUMENTS_AUTOMATIC is also
+ * non-zero, this function will not return; rather, it will terminate the
+ * process with the return code 0.
+ *
+ * If ARGUMENTS_AUTOMATIC is non-zero, this function will automatically
+ * initialise the argument struct and then parse all arguments. If an invalid
+ * argument value is encountered, it will not return; rather, it will terminate
+ * the process with the return code 1.
+ *
+ * @param ctx
+ *     The context.
+ * @param argv
+ *     The argument vector, typically the same as argv of the standard main
+ *     function.
+ * @param argc
+ *     The number of elements in argv.
+ * @param nextarg
+ *     The index of the first argument to examine. Upon return, the int pointed
+ *     to by this argument will contain the index of the next unparsed argument.
+ *     If nextarg == argc, all arguments were parsed. If an error occurred
+ *     while parsing an argument, nextarg will contain its index.
+ * @param pass
+ *     The pass to perform. If this is AP_COUNT, the help message is not
+ *     printed.
+ * @return AC_OK if no error occurred, AC_HELP if --help was encountered and
+ *     ARGUMENTS_PRINT_HELP was non-zero, or AC_INVALID if an invalid value was
+ *     passed
+ */
+static int
+arguments_read_pass(struct arguments_context_t *ctx, int argc, char *argv[],
+    int *nextarg, int pass)
+{
+    int is_valid = 1;
+
+    if (*nextarg < 1) {
+        *nextarg = 1;
+    }
+
+    /* Parse the command line */
+    while (*nextarg < argc && is_valid) {
+        int index, position;
+
+        /* If ARGUMENTS_PRINT_HELP is defined, we handle --help and -h */
+#if ARGUMENTS_PRINT_HELP
+        if ((strcmp(argv[*nextarg], "--help") == 0)
+                || (strcmp(argv[*nextarg], "-h") == 0)) {
+            if (pass != AP_COUNT) {
+                arguments_print_help();
+            }
+            return AC_HELP;
+        }
+#endif
+
+        index = arguments_lookup(argv[*nextarg], ctx->state->command);
+        position = *nextarg + 1;
+        if (index >= 0) {
+            is_valid = arguments_take(ctx, index, argc, argv, &position,
+                pass);
+        }
+#if ARGUMENTS_SHORT_BUNDLES
+        else if (arguments_is_bundle(argv[*nextarg], ctx->state->command)) {
+            /* The arguments of a bundle read their values in turn from the
+               command line arguments following the bundle */
+            const char *c;
+
+            for (c = argv[*nextarg] + 1; *c && is_valid; c++) {
+                is_valid = arguments_take(ctx,
+                    arguments_short_table[ctx->state->command][
+                        (unsigned char)*c] - 1,
+                    argc, argv, &position, pass);
+            }
+        }
+#endif
+        else {
+            /* If no argument matched the current one, break */
+            break;
+        }
+
+        if (is_valid) {
+            *nextarg = position;
+        }
+    }
+
+    /* is_valid is non-zero unless a command line parameter is missing */
+    return is_valid ? AC_OK : AC_ERROR;
+}
+
+/**
+ * Parses the command line given by argv and argc.
  *
  * If ARGUMENTS_AUTOMATIC is not defined, this function will simply parse the
  * arguments from argv[*nextarg] until either the end of argv is reached or an
  * invalid argument value is encountered.
  *
- * If ARGUMENTS_PRINT_HELP is non-zero, this function will print a help message
- * if the arguments --help or -h are encountered. If ARGUMENTS_AUTOMATIC is also
- * non-zero, this function will not return; rather, it will terminate the
- * process with the return code 0.
+ * Arguments with the flag ARGUMENT_ACCUMULATE are treated like any other
+ * argument by this function; use arguments_scan to accumulate their values.
+ *
+ * Response files are not expanded by this function either. If
+ * ARGUMENTS_RESPONSE_FILES is non-zero, call arguments_expand first and pass
+ * the expanded command line, to which *nextarg then refers.
+ *
+ * See arguments_read_pass for a description of the parameters and the return
+ * value.
+ *
+ * This function is not available if ARGUMENTS_AUTOMATIC is non-zero.
+ */
+#if !ARGUMENTS_AUTOMATIC
+static int
+arguments_read(int argc, char *argv[], int *nextarg)
+{
+    return arguments_read_pass(&arguments_context, argc, argv, nextarg,
+        AP_READ);
+}
+#endif
+
+/**
+ * Adds command line arguments to a list of ranges.
+ *
+ * If the new command line arguments immediately follow the last range, that
+ * range is extended.
+ *
+ * @param ranges
+ *     The list of ranges.
+ * @param first
+ *     The index of the first command line argument to add.
+ * @param length
+ *     The number of command line arguments to add.
+ * @return non-zero upon success, or 0 if memory could not be allocated
+ */
+static int
+arguments_ranges_add(struct arguments_ranges_t *ranges, int first, int length)
+{
+    struct arguments_range_t *last = ranges->ranges_length
+        ? ranges->ranges + ranges->ranges_length - 1
+        : NULL;
+
+    if (last && (last->first + last->length == first)) {
+        last->length += length;
+    }
+    else {
+        if (ranges->ranges_length == ranges->ranges_size) {
+            unsigned int size = ranges->ranges_size
+                ? 2 * ranges->ranges_size
+                : 8;
+            struct arguments_range_t *new_ranges = (struct arguments_range_t*)
+                realloc(ranges->ranges, size * sizeof(*new_ranges));
+
+            if (!new_ranges) {
+                return 0;
+            }
+            ranges->ranges = new_ranges;
+            ranges->ranges_size = size;
+        }
+
+        ranges->ranges[ranges->ranges_length].first = first;
+        ranges->ranges[ranges->ranges_length].length = length;
+        ranges->ranges_length++;
+    }
+
+    ranges->count += length;
+
+    return 1;
+}
+
+/**
+ * Performs a single pass over the entire command line for arguments_scan.
+ *
+ * @param ctx
+ *     The context.
+ * @param argc, argv
+ *     The command line.
+ * @param pass
+ *     The pass to perform. Unless this is AP_COUNT, the positional and
+ *     unknown command line arguments are collected in the rest of the
+ *     context.
+ * @return AC_OK if no error occurred, AC_HELP if --help was encountered and
+ *     ARGUMENTS_PRINT_HELP was non-zero, or AC_ERROR if an argument was not
+ *     passed enough values or memory could not be allocated
+ */
+static int
+arguments_scan_pass(struct arguments_context_t *ctx, int argc, char *argv[],
+    int pass)
+{
+    int nextarg = 1, is_first_positional = 1;
+
+    /* Every pass selects the command anew, so that all passes match the same
+       arguments */
+    ctx->state->command = ACMD_NONE;
+
+    while (nextarg < argc) {
+        const char *arg;
+        int result, command;
+
+        /* Read arguments until a command line argument does not match */
+        result = arguments_read_pass(ctx, argc, argv, &nextarg, pass);
+        if (result != AC_OK) {
+            return result;
+        }
+        else if (nextarg == argc) {
+            break;
+        }
+
+        arg = argv[nextarg];
+        if (strcmp(arg, "--") == 0) {
+            if ((pass != AP_COUNT) && (nextarg + 1 < argc)
+                    && !arguments_ranges_add(&ctx->rest->positional,
+                        nextarg + 1, argc - nextarg - 1)) {
+                return AC_ERROR;
+            }
+            break;
+        }
+        else if (arguments_is_option(arg)) {
+            if ((pass != AP_COUNT)
+                    && !arguments_ranges_add(&ctx->rest->unknown,
+                        nextarg, 1)) {
+                return AC_ERROR;
+            }
+            nextarg++;
+        }
+        else if (is_first_positional
+                && ((command = arguments_lookup_command(arg)) != ACMD_NONE)) {
+            /* The first positional argument selects a command, whose
+               arguments are matched from here on */
+            ctx->state->command = command;
+            is_first_positional = 0;
+            nextarg++;
+        }
+        else {
+            is_first_positional = 0;
+#if ARGUMENTS_PERMUTE
+            if ((pass != AP_COUNT)
+                    && !arguments_ranges_add(&ctx->rest->positional,
+                        nextarg, 1)) {
+                return AC_ERROR;
+            }
+            nextarg++;
+#else
+            if ((pass != AP_COUNT)
+                    && !arguments_ranges_add(&ctx->rest->positional,
+                        nextarg, argc - nextarg)) {
+                return AC_ERROR;
+            }
+            break;
+#endif
+        }
+    }
+
+    return AC_OK;
+}
+
+/**
+ * Allocates the storage for the values of all arguments with the flag
+ * ARGUMENT_ACCUMULATE after an AP_COUNT pass.
+ *
+ * @param ctx
+ *     The context.
+ * @return non-zero upon success, or 0 if memory could not be allocated
+ */
+static int
+arguments_accumulate_allocate(struct arguments_context_t *ctx)
+{
+    size_t total = 0;
+    char **current;
+    int i;
+
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        if (arguments_flags[i] & ARGUMENT_ACCUMULATE) {
+            total += ctx->state->strings[i].value_strings_length;
+        }
+    }
+
+    free(ctx->accumulated);
+    ctx->accumulated = total
+        ? (char**)malloc(total * sizeof(*ctx->accumulated))
+        : NULL;
+    if (total && !ctx->accumulated) {
+        return 0;
+    }
+
+    /* Every argument gets a slice of exactly the counted size */
+    current = ctx->accumulated;
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        if (arguments_flags[i] & ARGUMENT_ACCUMULATE) {
+            struct arguments_strings_t *strings = &ctx->state->strings[i];
+
+            strings->value_strings = current;
+            current += strings->value_strings_length;
+            strings->value_strings_length = 0;
+        }
+    }
+
+    return 1;
+}
+
+#ifdef ARGUMENTS_ENVIRONMENT_PREFIX
+    #include "arguments-environment.h"
+#endif
+
+#ifdef ARGUMENTS_COMPLETE
+    #include "arguments-complete.h"
+#endif
+
+/**
+ * Parses the entire command line given by argv and argc.
+ *
+ * Unlike arguments_read, this function does not stop at command line
+ * arguments that do not match any argument; these are collected in the rest
+ * of the context instead. A command line argument starting with "-" is added
+ * to rest->unknown, and any other command line argument is added to
+ * rest->positional. All command line arguments following "--" are
+ * positional.
+ *
+ * If ARGUMENTS_RESPONSE_FILES is non-zero, response files are first
+ * expanded into ctx->responses, and the ranges in the rest of the context
+ * refer to the expanded command line ctx->responses.argv.
+ *
+ * If ARGUMENTS_PERMUTE is zero, the first positional argument and all
+ * command line arguments following it are positional.
+ *
+ * If the first positional argument names a command defined with
+ * ARGUMENT_COMMAND, it selects that command instead of being added to
+ * rest->positional, and the arguments of the command are matched in the
+ * command line arguments following it.
+ *
+ * If any argument has the flag ARGUMENT_ACCUMULATE, the command line is first
+ * scanned once to count the values of those arguments, so that the storage
+ * for all of them can be allocated at once.
+ *
+ * If ARGUMENTS_ENVIRONMENT_PREFIX is defined, the arguments not passed on the
+ * command line are then read from the environment with
+ * arguments_read_environment. If ARGUMENTS_CONFIG_FILES is non-zero and the
+ * context has a config_path, the arguments still not present are read from
+ * that file with arguments_read_config.
+ *
+ * @param ctx
+ *     The context.
+ * @param argc, argv
+ *     The command line.
+ * @return AC_OK if no error occurred, AC_HELP if --help was encountered and
+ *     ARGUMENTS_PRINT_HELP was non-zero, or AC_ERROR if an argument was not
+ *     passed enough values or memory could not be allocated
+ */
+static int
+arguments_scan_ctx(struct arguments_context_t *ctx, int argc, char *argv[])
+{
+    int pass = AP_READ;
+    int result;
+
+#if ARGUMENTS_RESPONSE_FILES
+    /* Replace any response files with their contents */
+    if (arguments_response_expand(&ctx->responses, &argc, &argv) != AC_OK) {
+        return AC_ERROR;
+    }
+#endif
+
+    /* If the counting pass fails, the reading pass will fail in the same
+       way, so we let it report the error */
+    if (arguments_accumulating
+            && (arguments_scan_pass(ctx, argc, argv, AP_COUNT) == AC_OK)) {
+        if (!arguments_accumulate_allocate(ctx)) {
+            return AC_ERROR;
+        }
+        pass = AP_ACCUMULATE;
+    }
+
+    result = arguments_scan_pass(ctx, argc, argv, pass);
+
+    /* Read the sources with lower precedence than the command line */
+#ifdef ARGUMENTS_ENVIRONMENT_PREFIX
+    if (result == AC_OK) {
+        result = arguments_read_environment(ctx);
+    }
+#endif
+#if ARGUMENTS_CONFIG_FILES
+    if ((result == AC_OK) && ctx->config_path) {
+        result = arguments_read_config(ctx, ctx->config_path);
+    }
+#endif
+
+    return result;
+}
+
+/**
+ * Parses the entire command line given by argv and argc into the global
+ * variables.
+ *
+ * See arguments_scan_ctx for a description of the parameters and the return
+ * value.
+ */
+static int
+arguments_scan(int argc, char *argv[])
+{
+    return arguments_scan_ctx(&arguments_context, argc, argv);
+}
+
+/**
+ * The converters of the arguments.
+ *
+ * For every argument, the function
+ * static int arguments_convert_name(struct arguments_context_t *ctx) is
+ * defined. It executes read if the argument was present on the command line
+ * and set_default otherwise, and marks the argument as initialised if the
+ * value was valid.
+ *
+ * The readers see arguments_current and arguments_current_state pointing into
+ * ctx, so that ARGUMENT_VALUE and ARGUMENT_IS_PRESENT read the same context.
+ *
+ * They return non-zero if the value was valid, and 0 otherwise.
+ */
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    static int \
+    arguments_convert_##name(struct arguments_context_t *ctx) \
+    { \
+        int is_valid = 1; \
+        struct arguments_t *arguments_current = ctx->values; \
+        struct arguments_state_t *arguments_current_state = ctx->state; \
+        name##_t *target = &ctx->values->name; \
+        struct arguments_arena_t *arena = &ctx->arena; \
+        char **value_strings = \
+            ctx->state->strings[AI_##name].value_strings; \
+        unsigned int value_strings_length = \
+            ctx->state->strings[AI_##name].value_strings_length; \
+        ARGUMENTS_PROFILE_START \
+        \
+        if (arguments_bit_get(ctx->state->present, AI_##name)) { \
+            read \
+        } \
+        else { \
+            set_default \
+        } \
+        \
+        ARGUMENTS_PROFILE_STOP(ctx->profile.converted[AI_##name]) \
+        if (is_valid) { \
+            arguments_bit_set_shared(ctx->state->initialized, AI_##name); \
+        } \
+        \
+        if (arguments_current); \
+        if (arguments_current_state); \
+        if (target); \
+        if (arena); \
+        if (value_strings); \
+        if (value_strings_length); \
+        \
+        return is_valid; \
+    }
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#include "../arguments.def"
+
+
+/**
+ * The converters of the arguments, indexed by AI_name.
+ */
+static int (*const arguments_converters[ARGUMENTS_COUNT + 1])(
+    struct arguments_context_t*) = {
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    arguments_convert_##name,
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#include "../arguments.def"
+    NULL
+};
+
+
+#if ARGUMENTS_PARALLEL && !ARGUMENTS_LAZY
+    #include "arguments-parallel.h"
+#endif
+
+
+#if ARGUMENTS_LAZY
+
+/**
+ * The resolvers of the arguments.
+ *
+ * For every argument, the function static void arguments_resolve_name(void)
+ * is defined. It converts the value unless it has already been converted,
+ * guarded by a once flag, so it may be called from several threads.
+ */
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    static void \
+    arguments_resolve_##name(void) \
+    { \
+        if (arguments_once_begin(&arguments_state.once[AI_##name])) { \
+            arguments_convert_##name(&arguments_context); \
+            arguments_once_end(&arguments_state.once[AI_##name]); \
+        } \
+    }
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#include "../arguments.def"
+
+/**
+ * The resolvers of the arguments, indexed by AI_name.
+ */
+static void (*const arguments_resolvers[ARGUMENTS_COUNT + 1])(void) = {
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    arguments_resolve_##name,
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#include "../arguments.def"
+    NULL
+};
+
+/**
+ * The accessors of the arguments; see the declarations above.
+ *
+ * If the value is invalid, the process is terminated with the return code
+ * ARGUMENTS_PARAMETER_INVALID, since ARGUMENT_VALUE cannot report errors.
+ * exit is called by the thread reading the value first, which may be any
+ * thread started by run, so the functions registered with atexit, including
+ * arguments_release, run while other threads may still be using values.
+ */
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    name##_t * \
+    arguments_get_##name(void) \
+    { \
+        arguments_resolve_##name(); \
+        if (!arguments_bit_get_shared(arguments_state.initialized, \
+                AI_##name)) { \
+            exit(ARGUMENTS_PARAMETER_INVALID); \
+        } \
+        \
+        return &arguments.name; \
+    }
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#include "../arguments.def"
+
+/**
+ * The threads started by arguments_async_start.
+ */
+static arguments_thread_t arguments_async_threads[ARGUMENTS_COUNT + 1];
+
+/**
+ * The number of elements in arguments_async_threads.
+ */
+static int arguments_async_threads_length;
+
+/**
+ * The thread function converting an argument with the flag ARGUMENT_ASYNC.
+ *
+ * @param arg
+ *     The index of the argument, cast to a pointer.
+ */
+ARGUMENTS_THREAD_FUNCTION(arguments_async_worker, arg)
+{
+    arguments_resolvers[(size_t)arg]();
+
+    return ARGUMENTS_THREAD_RESULT;
+}
+
+/**
+ * Starts converting all arguments with the flag ARGUMENT_ASYNC on background
+ * threads.
+ *
+ * If a thread cannot be started, the argument is converted when it is first
+ * read instead.
+ */
+static void
+arguments_async_start(void)
+{
+    size_t i;
+
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        if ((arguments_flags[i] & ARGUMENT_ASYNC)
+                && arguments_is_visible(i, arguments_state.command)
+                && arguments_thread_start(
+                    &arguments_async_threads[arguments_async_threads_length],
+                    arguments_async_worker, (void*)i)) {
+            arguments_async_threads_length++;
+        }
+    }
+}
+
+/**
+ * Waits for all threads started by arguments_async_start to terminate.
+ */
+static void
+arguments_async_join(void)
+{
+    int i;
+
+    for (i = 0; i < arguments_async_threads_length; i++) {
+        arguments_thread_join(arguments_async_threads[i]);
+    }
+    arguments_async_threads_length = 0;
+}
+
+#endif
+
+
+/**
+ * Converts the values of all arguments of a context.
  *
- * If ARGUMENTS_AUTOMATIC is non-zero, this function will automatically
- * initialise the argument struct and then parse all arguments. If an invalid
- * argument value is encountered, it will not return; rather, it will terminate
- * the process with the return code 1.
+ * If ARGUMENTS_LAZY is non-zero, no values are converted by this function;
+ * every value is instead converted the first time it is read with
+ * ARGUMENT_VALUE, or on a background thread started by this function if the
+ * argument has the flag ARGUMENT_ASYNC. Otherwise, if ARGUMENTS_PARALLEL is
+ * non-zero, arguments with the flag ARGUMENT_INDEPENDENT are converted on
+ * worker threads.
  *
- * @param argv
- *     The argument vector, typically the same as argv of the standard main
- *     function.
- * @param argc
- *     The number of elements in argv.
- * @param nextarg
- *     The index of the first argument to examine. Upon return, the int pointed
- *     to by this argument will contain the index of the next unparsed argument.
- *     If nextarg == argc, all arguments were parsed. If an error occurred
- *     while parsing an argument, nextarg will contain its index.
- * @return AC_OK if no error occurred, AC_HELP if --help was encountered and
- *     ARGUMENTS_PRINT_HELP was non-zero, or AC_INVALID if an invalid value was
- *     passed
+ * Only the global arguments and those of the selected command are converted;
+ * the values of all other arguments remain zeroed.
+ *
+ * If ARGUMENTS_SNAPSHOTS is non-zero and the context has a snapshot, the
+ * values are first loaded from it with arguments_load_snapshot, and only the
+ * arguments not loaded are converted.
+ *
+ * @param ctx
+ *     The context.
+ * @return AC_OK if all values were valid, or AC_ERROR otherwise
  */
 static int
-arguments_read(int argc, char *argv[], int *nextarg)
+arguments_set_ctx(struct arguments_context_t *ctx)
 {
     int is_valid = 1;
 
-    if (*nextarg < 1) {
-        *nextarg = 1;
+#if ARGUMENTS_SNAPSHOTS && !ARGUMENTS_LAZY
+    /* An unusable snapshot only means that everything is converted */
+    if (ctx->snapshot) {
+        arguments_load_snapshot(ctx);
     }
+#endif
 
-    /* Parse the command line */
-    while (*nextarg < argc && is_valid) {
-        /* If ARGUMENTS_PRINT_HELP is defined, we handle --help and -h */
-#if ARGUMENTS_PRINT_HELP
-        if ((strcmp(argv[*nextarg], "--help") == 0)
-                || (strcmp(argv[*nextarg], "-h") == 0)) {
-            arguments_print_help();
-            return AC_HELP;
-        }
+#if ARGUMENTS_LAZY
+    (void)ctx;
+    arguments_async_start();
+#elif ARGUMENTS_PARALLEL
+    is_valid = arguments_parallel_convert(ctx);
 #else
-        /* If ARGUMENTS_PRINT_HELP is zero, we need a dummy if statement to
-           allow the following list of else ifs */
-        if (0);
-#endif
-
-    #undef ARGUMENT
-    #define ARGUMENT(type, name, short, help, value_count, is_required, \
-            set_default, read, release) \
-        else if ((arguments_cmp(argv[*nextarg], #name) == 0) \
-                || (strcmp(argv[*nextarg], short ? short : "") == 0)) { \
-            arguments.name.present = 1; \
-            arguments.name.value_strings_length = value_count; \
-            \
-            if (*nextarg + (int)arguments.name.value_strings_length < argc) { \
-                (*nextarg)++; \
-                arguments.name.value_strings = argv + *nextarg; \
-                *nextarg += arguments.name.value_strings_length; \
-            } \
-            else { \
-                is_valid = 0; \
-                break; \
-            } \
-        }
-    #undef ARGUMENT_SECTION
-    #define ARGUMENT_SECTION(text)
-    #include "../arguments.def"
-
-        else {
-            /* If no argument matched the current one, break */
-            break;
-        }
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    if (is_valid && arguments_is_visible(AI_##name, ctx->state->command) \
+            && !arguments_bit_get(ctx->state->initialized, AI_##name)) { \
+        is_valid = arguments_convert_##name(ctx); \
     }
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text)
+#include "../arguments.def"
+#endif
 
-    /* is_valid is non-zero unless a command line parameter is missing */
     return is_valid ? AC_OK : AC_ERROR;
 }
 
 /**
- * Call this function after all invocations of arguments_read.
+ * Call this function after all invocations of arguments_read or
+ * arguments_scan.
  *
  * It will set the default values for all arguments that have not been passed on
- * the command line. If an argument that was required has not been passed, this
- * function will return AC_ERROR.
+ * the command line, and register arguments_release to be called when the
+ * process terminates. See arguments_set_ctx.
  *
- * @return AC_OK if all required arguments have been passed, or AC_ERROR if a
- *     parameter error is encountered
+ * @return AC_OK if all values were valid, or AC_ERROR if a parameter error is
+ *     encountered
  */
 static int
 arguments_set(void)
 {
-    int is_valid = 1;
+    int result = arguments_set_ctx(&arguments_context);
+
+    /* This function has to be called */
+    atexit(arguments_release);
+
+#if ARGUMENTS_LAZY
+    /* Functions registered with atexit are called in reverse order, so any
+       background conversions are complete before the values are released */
+    atexit(arguments_async_join);
+#endif
+
+    return result;
+}
+
+
+/**
+ * Verifies that all required arguments of a context have been passed; the
+ * arguments of commands that have not been selected are not required.
+ *
+ * If ARGUMENTS_PRINT_MISSING_FORMAT is defined, the name of the first missing
+ * argument is printed to stderr with this format.
+ *
+ * @param ctx
+ *     The context.
+ * @return AC_OK if all required arguments have been passed, or AC_ERROR
+ *     otherwise
+ */
+#ifdef ARGUMENTS_PRINT_MISSING_FORMAT
+    #define print_missing(name) \
+        fprintf(stderr, ARGUMENTS_PRINT_MISSING_FORMAT, name)
+#else
+    #define print_missing(name)
+#endif
+static int
+arguments_check(struct arguments_context_t *ctx)
+{
+    struct arguments_t *arguments_current = ctx->values;
+    struct arguments_state_t *arguments_current_state = ctx->state;
 
 #undef ARGUMENT
 #define ARGUMENT(type, name, short, help, value_count, is_required, \
         set_default, read, release) \
-    if (is_valid) { \
-        name##_t *target = &arguments.name.value; \
-        char **value_strings = \
-            arguments.name.value_strings; \
-        unsigned int value_strings_length = \
-            arguments.name.value_strings_length; \
-        \
-        if (arguments.name.present) { \
-            read \
-        } \
-        else { \
-            set_default \
-        } \
-        \
-        if (is_valid) { \
-            arguments.name.initialized = 1; \
-        } \
-        \
-        if (target); \
-        if (value_strings); \
-        if (value_strings_length); \
+    if (arguments_is_visible(AI_##name, ctx->state->command) \
+            && (is_required) && !ARGUMENT_IS_PRESENT(name)) { \
+        print_missing(#name); \
+        return AC_ERROR; \
     }
 #undef ARGUMENT_SECTION
 #define ARGUMENT_SECTION(text)
 #include "../arguments.def"
 
-    /* This function has to be called */
-    atexit(arguments_release);
+    if (arguments_current);
+    if (arguments_current_state);
 
-    return is_valid ? AC_OK : AC_ERROR;
+    return AC_OK;
+}
+
+
+#if !ARGUMENTS_LAZY
+/**
+ * The storage of a context created with arguments_create_ctx.
+ *
+ * The context is the first member, so a pointer to it is also a pointer to
+ * the storage.
+ */
+struct arguments_context_storage_t {
+    struct arguments_context_t context;
+    struct arguments_t values;
+    struct arguments_state_t state;
+    struct arguments_rest_t rest;
+};
+
+/**
+ * Creates a context for parsing command lines independently of the global
+ * variables and of other contexts.
+ *
+ * The lookup tables are shared by all contexts and never modified once they
+ * have been prepared, so different contexts may be used by different threads
+ * at the same time. The first call to this function or arguments_initialize
+ * prepares them; threads creating contexts meanwhile wait for it.
+ *
+ * This function is not available if ARGUMENTS_LAZY is non-zero.
+ *
+ * @return the context, which must be released with arguments_release_ctx, or
+ *     NULL if it could not be allocated
+ */
+static ARGUMENTS_UNUSED struct arguments_context_t *
+arguments_create_ctx(void)
+{
+    struct arguments_context_storage_t *storage =
+        (struct arguments_context_storage_t*)calloc(1, sizeof(*storage));
+
+    if (!storage) {
+        return NULL;
+    }
+
+    arguments_prepare();
+
+    storage->context.values = &storage->values;
+    storage->context.state = &storage->state;
+    storage->context.rest = &storage->rest;
+
+    return &storage->context;
+}
+
+/**
+ * Releases the values of a context and clears it, so that it may parse
+ * another command line.
+ *
+ * The memory of the arena and of the ranges is kept for the next command line;
+ * a mapped configuration file and any response files are unmapped, and a
+ * command line converted by arguments_parse_wide_ctx is freed.
+ *
+ * @param ctx
+ *     The context.
+ */
+static ARGUMENTS_UNUSED void
+arguments_reset_ctx(struct arguments_context_t *ctx)
+{
+    arguments_release_values(ctx, 0);
+    arguments_arena_reset(&ctx->arena);
+
+    free(ctx->argv);
+    ctx->argv = NULL;
+
+#if ARGUMENTS_CONFIG_FILES
+    arguments_config_unmap(ctx);
+#endif
+
+#if ARGUMENTS_RESPONSE_FILES
+    arguments_response_release(&ctx->responses);
+#endif
+
+    memset(ctx->values, 0, sizeof(*ctx->values));
+    memset(ctx->state, 0, sizeof(*ctx->state));
+    ctx->rest->positional.ranges_length = 0;
+    ctx->rest->positional.count = 0;
+    ctx->rest->unknown.ranges_length = 0;
+    ctx->rest->unknown.count = 0;
+}
+
+/**
+ * Parses an entire command line into a context.
+ *
+ * The context is reset first, so it may be reused for any number of command
+ * lines; the values remain valid until the next call or until the context is
+ * released. Unlike arguments_set, this function does not register anything
+ * to be called when the process terminates.
+ *
+ * See arguments_scan_ctx for a description of the parameters.
+ *
+ * @param ctx
+ *     The context, created with arguments_create_ctx.
+ * @return AC_OK if the command line was valid, AC_HELP if --help was
+ *     encountered and ARGUMENTS_PRINT_HELP is non-zero, or AC_ERROR if an
+ *     invalid or missing argument was encountered
+ */
+static ARGUMENTS_UNUSED int
+arguments_parse_ctx(struct arguments_context_t *ctx, int argc, char *argv[])
+{
+    int result;
+
+    arguments_reset_ctx(ctx);
+
+    result = arguments_scan_ctx(ctx, argc, argv);
+    if (result == AC_OK) {
+        result = arguments_check(ctx);
+    }
+    if (result == AC_OK) {
+        result = arguments_set_ctx(ctx);
+    }
+
+    return result;
+}
+
+#if defined(WIN32)
+/**
+ * Parses an entire wide character command line into a context.
+ *
+ * The command line is converted to UTF-8 first; the converted strings, to
+ * which the values and ranges of the context refer, are kept until the context
+ * is reset or released. See arguments_parse_ctx.
+ *
+ * @param ctx
+ *     The context, created with arguments_create_ctx.
+ * @param argc, wargv
+ *     The wide character command line, for example as returned by
+ *     CommandLineToArgvW.
+ * @return AC_OK if the command line was valid, AC_HELP if --help was
+ *     encountered and ARGUMENTS_PRINT_HELP is non-zero, or AC_ERROR if an
+ *     invalid or missing argument was encountered or memory could not be
+ *     allocated
+ */
+static ARGUMENTS_UNUSED int
+arguments_parse_wide_ctx(struct arguments_context_t *ctx, int argc,
+    wchar_t *wargv[])
+{
+    char **argv = arguments_argv_from_wide(argc, wargv);
+    int result;
+
+    if (!argv) {
+        return AC_ERROR;
+    }
+
+    /* Parsing resets the context, which frees the previous command line */
+    result = arguments_parse_ctx(ctx, argc, argv);
+    ctx->argv = argv;
+
+    return result;
+}
+#endif
+
+/**
+ * Releases a context created with arguments_create_ctx and all memory it
+ * holds.
+ *
+ * @param ctx
+ *     The context.
+ */
+static ARGUMENTS_UNUSED void
+arguments_release_ctx(struct arguments_context_t *ctx)
+{
+    arguments_release_values(ctx, 0);
+    arguments_release_storage(ctx);
+    free(ctx);
 }
+#endif
+
+#if ARGUMENTS_RELOAD && !ARGUMENTS_LAZY
+    #include "arguments-reload.h"
+#endif
 
 
 /*
@@ -490,6 +2703,71 @@ arguments_set(void)
  */
 #if ARGUMENTS_AUTOMATIC
 
+#if ARGUMENTS_PROFILE
+/**
+ * Calls arguments_teardown and measures the time spent in it.
+ */
+static void
+arguments_profile_teardown(void)
+{
+    ARGUMENTS_PROFILE_START
+
+    arguments_teardown();
+
+    ARGUMENTS_PROFILE_STOP(arguments_context.profile.teardown)
+}
+
+/**
+ * Prints the profile of the global variables to stderr.
+ */
+static void
+arguments_profile_dump(void)
+{
+    arguments_profile_print(stderr, &arguments_context.profile);
+}
+#endif
+
+#if ARGUMENTS_FAST_EXIT && !ARGUMENTS_LAZY && !ARGUMENTS_RELOAD
+/**
+ * Terminates the process once run has returned, unless an argument must be
+ * released when the process terminates.
+ *
+ * Only arguments_teardown, which would otherwise be called by atexit, is
+ * called before the output streams are flushed and the process terminated.
+ *
+ * This is not available if ARGUMENTS_RELOAD is non-zero, since the values
+ * published by arguments_reload are released by arguments_reload_release,
+ * which is registered with atexit.
+ *
+ * @param result
+ *     The return code of the process.
+ */
+static void
+arguments_fast_exit(int result)
+{
+    int i;
+
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        if (arguments_bit_get(arguments_state.initialized, i)
+                && arguments_is_released_at_exit(i)) {
+            return;
+        }
+    }
+
+#if ARGUMENTS_PROFILE
+    arguments_profile_teardown();
+    if (getenv(ARGUMENTS_PROFILE_ENVIRONMENT)) {
+        arguments_profile_dump();
+    }
+#else
+    arguments_teardown();
+#endif
+
+    fflush(NULL);
+    _Exit(result);
+}
+#endif
+
 #if !defined(WIN32) || defined(_CONSOLE)
 int
 main(int argc, char *argv[])
@@ -502,38 +2780,45 @@ wWinMain(HINSTANCE instance, HINSTANCE prev, LPTSTR targs, int show)
     char **argv;
 #endif
     int result;
-    int nextarg = 1;
 
     arguments_initialize();
 
+#if ARGUMENTS_RELOAD && !ARGUMENTS_LAZY
+    /* The reload signal must be blocked before arguments_setup, run or
+       arguments_set start any thread, since a thread receiving it would
+       otherwise terminate the process */
+    arguments_reload_block();
+#endif
+
 #if defined(WIN32)
     /* On Windows, we need to create out own arguments from the wide character
        arguments to maintain the character encoding */
     if (1) {
         wchar_t **wargv;
 
+        /* The converted command line is kept by the global context until the
+           process terminates */
         wargv = CommandLineToArgvW(GetCommandLine(), &argc);
-        argv = NULL;
-        if (wargv) {
-            int i;
-
-            argv = (char**)alloca(argc * sizeof(argv[0]));
-            for (i = 0; i < argc; i++) {
-                size_t size = WideCharToMultiByte(CP_UTF8, 0, wargv[i], -1,
-                    NULL, 0, NULL, NULL);
-                char *arg = (char*)alloca(size);
-
-                WideCharToMultiByte(CP_UTF8, 0, wargv[i], -1, arg, size,
-                    NULL, NULL);
-                argv[i] = arg;
-            }
-        }
+        argv = wargv ? arguments_argv_from_wide(argc, wargv) : NULL;
         LocalFree(wargv);
+        if (!argv) {
+            return ARGUMENTS_PARAMETER_INVALID;
+        }
+        arguments_context.argv = argv;
+    }
+#endif
+
+#ifdef ARGUMENTS_COMPLETE
+    /* Shells complete the command line by passing it after the hidden
+       argument ARGUMENTS_COMPLETE */
+    if ((argc > 1) && (strcmp(argv[1], ARGUMENTS_COMPLETE) == 0)) {
+        arguments_complete(argc - 2, argv + 2, stdout);
+        return 0;
     }
 #endif
 
     /* First parse the arguments */
-    switch (arguments_read(argc, argv, &nextarg)) {
+    switch (arguments_scan(argc, argv)) {
     case AC_OK:
         /* Just continue if no invalid arguments were found */
         break;
@@ -548,33 +2833,46 @@ wWinMain(HINSTANCE instance, HINSTANCE prev, LPTSTR targs, int show)
     }
 
     /* Detect missing arguments */
-#ifdef ARGUMENTS_PRINT_MISSING_FORMAT
-    #define print_missing(name) \
-        fprintf(stderr, ARGUMENTS_PRINT_MISSING_FORMAT, name)
-#else
-    #define print_missing(name)
-#endif
+    if (arguments_check(&arguments_context) != AC_OK) {
+        return ARGUMENTS_PARAMETER_MISSING;
+    }
 
-#undef ARGUMENT
-#define ARGUMENT(type, name, short, help, value_count, is_required, \
-        set_default, read, release) \
-    if ((is_required) && !arguments.name.present) { \
-        print_missing(#name); \
-        return ARGUMENTS_PARAMETER_MISSING; \
+#if ARGUMENTS_PROFILE
+    /* The profile is printed after everything else registered below has
+       run */
+    if (getenv(ARGUMENTS_PROFILE_ENVIRONMENT)) {
+        atexit(arguments_profile_dump);
     }
-#undef ARGUMENT_SECTION
-#define ARGUMENT_SECTION(text)
-#include "../arguments.def"
+#endif
 
     /* Call setup before converting the parameter values to variables */
-    result = arguments_setup(argc, argv);
+    {
+        ARGUMENTS_PROFILE_START
+
+        result = arguments_setup(argc, argv);
+
+        ARGUMENTS_PROFILE_STOP(arguments_context.profile.setup)
+    }
     if (result != 0) {
         return result;
     }
 
     /* Once we have successfully called setup, we must make sure that teardown
        is also called */
+#if ARGUMENTS_PROFILE
+    atexit(arguments_profile_teardown);
+#else
     atexit(arguments_teardown);
+#endif
+
+#if ARGUMENTS_SNAPSHOTS && !ARGUMENTS_LAZY
+    /* A process started with a snapshot loads the values from it instead of
+       converting them */
+    if (getenv(ARGUMENTS_SNAPSHOT_ENVIRONMENT)) {
+        arguments_map_snapshot(&arguments_context,
+            atoi(getenv(ARGUMENTS_SNAPSHOT_ENVIRONMENT)));
+    }
+#endif
 
     /* Actually converts the string values read to variables */
     switch (arguments_set()) {
@@ -588,15 +2886,41 @@ wWinMain(HINSTANCE instance, HINSTANCE prev, LPTSTR targs, int show)
         return ARGUMENTS_PARAMETER_INVALID;
     }
 
-    return run(argc, argv
+#if ARGUMENTS_RELOAD && !ARGUMENTS_LAZY
+    /* If the thread reloading the arguments upon a signal cannot be started,
+       they may still be reloaded by calling arguments_reload */
+    arguments_reload_start(argc, argv);
+#endif
+
+#if ARGUMENTS_RESPONSE_FILES
+    /* run is passed the command line with the response files expanded, to
+       which the ranges of arguments_rest refer */
+    if (arguments_context.responses.argv) {
+        argc = arguments_context.responses.argc;
+        argv = arguments_context.responses.argv;
+    }
+#endif
+
+    result = run(argc, argv
         #undef ARGUMENT
+        #if ARGUMENTS_LAZY
+        #define ARGUMENT(type, name, short, help, value_count, is_required, \
+                set_default, read, release)
+        #else
         #define ARGUMENT(type, name, short, help, value_count, is_required, \
                 set_default, read, release) \
-            , arguments.name.value
+            , arguments.name
+        #endif
         #undef ARGUMENT_SECTION
         #define ARGUMENT_SECTION(text)
         #include "../arguments.def"
     );
+
+#if ARGUMENTS_FAST_EXIT && !ARGUMENTS_LAZY && !ARGUMENTS_RELOAD
+    arguments_fast_exit(result);
+#endif
+
+    return result;
 }
 
 
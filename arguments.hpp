@@ -0,0 +1,1164 @@
+/**
+ * A C++17 front-end to arguments.def.
+ *
+ * Include this file instead of arguments.h from C++ programs with large
+ * definition files. arguments.h includes arguments.def once for every table
+ * and function it generates; this file includes it only once, and every
+ * invocation of ARGUMENT, ARGUMENT_SECTION and ARGUMENT_FLAGS defines an item,
+ * a specialisation of arguments_entry. The storage, the descriptor table and
+ * the signature of run are generated from the items with templates, and
+ * parsing, conversion, release and help are driven by the descriptor table.
+ *
+ * arguments.def is used unchanged, with the following limitations:
+ *
+ *   * ARGUMENT_COMMAND is not supported.
+ *   * ARGUMENT_DEPENDS, ARGUMENT_SNAPSHOT and the flags ARGUMENT_INDEPENDENT
+ *     and ARGUMENT_ASYNC are ignored, like in arguments.h without
+ *     ARGUMENTS_PARALLEL, ARGUMENTS_SNAPSHOTS and ARGUMENTS_LAZY, so
+ *     arguments are always converted and released in the order they are
+ *     defined.
+ *   * ARGUMENTS_LAZY, ARGUMENTS_PARALLEL, ARGUMENTS_RELOAD,
+ *     ARGUMENTS_SNAPSHOTS, ARGUMENTS_RESPONSE_FILES, ARGUMENTS_CONFIG_FILES,
+ *     ARGUMENTS_ABBREVIATIONS, ARGUMENTS_ENVIRONMENT_PREFIX, ARGUMENTS_COMPLETE
+ *     and ARGUMENTS_READ_ONLY are not available, nor are contexts.
+ *   * arguments.def must not use __COUNTER__, which numbers the items.
+ *
+ * Sections and flags are items as well, so AI_name is the number of the item,
+ * and ARGUMENTS_COUNT is the number of arguments, sections and invocations of
+ * ARGUMENT_FLAGS.
+ */
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "arguments-common.h"
+
+/**
+ * If this is non-zero, main is defined and calls run with the parsed values,
+ * like the main of arguments.h.
+ */
+#ifndef ARGUMENTS_AUTOMATIC
+    #define ARGUMENTS_AUTOMATIC 1
+#endif
+
+/**
+ * If this is non-zero, --help and -h print the help for all arguments.
+ */
+#ifndef ARGUMENTS_PRINT_HELP
+    #define ARGUMENTS_PRINT_HELP 1
+#endif
+
+/**
+ * The exit code of the automatic main if an argument is invalid.
+ */
+#ifndef ARGUMENTS_PARAMETER_INVALID
+    #define ARGUMENTS_PARAMETER_INVALID 110
+#endif
+
+/**
+ * The exit code of the automatic main if a required argument is missing.
+ */
+#ifndef ARGUMENTS_PARAMETER_MISSING
+    #define ARGUMENTS_PARAMETER_MISSING 120
+#endif
+
+/**
+ * If this is non-zero, several single character short options may be combined
+ * in one command line argument.
+ */
+#ifndef ARGUMENTS_SHORT_BUNDLES
+    #define ARGUMENTS_SHORT_BUNDLES 1
+#endif
+
+/**
+ * If this is non-zero, arguments and positional arguments may be mixed.
+ */
+#ifndef ARGUMENTS_PERMUTE
+    #define ARGUMENTS_PERMUTE 1
+#endif
+
+/**
+ * If this is non-zero, the readers in arguments-readers.h are available.
+ */
+#ifndef ARGUMENTS_READERS
+    #define ARGUMENTS_READERS 1
+#endif
+
+/**
+ * If this is non-zero, arguments with the flag ARGUMENT_DEBUG_RELEASE are
+ * released when the process terminates.
+ */
+#ifndef ARGUMENTS_LEAK_CHECK
+    #ifdef NDEBUG
+        #define ARGUMENTS_LEAK_CHECK 0
+    #else
+        #define ARGUMENTS_LEAK_CHECK 1
+    #endif
+#endif
+
+#include "arguments-arena.h"
+
+#if ARGUMENTS_READERS
+    #include "arguments-readers.h"
+#endif
+
+#if ARGUMENTS_PRINT_HELP
+    #include "arguments-layout.h"
+#endif
+
+/**
+ * Returns the value of an argument.
+ */
+#define ARGUMENT_VALUE(name) \
+    (arguments_current->name)
+
+/**
+ * Returns where the value of an argument was found.
+ */
+#define ARGUMENT_SOURCE(name) \
+    (arguments_current_state->arguments_sources[ \
+        arguments_current_state->name])
+
+/**
+ * Determines whether an argument was passed.
+ */
+#define ARGUMENT_IS_PRESENT(name) \
+    (ARGUMENT_SOURCE(name) != AS_DEFAULT)
+
+/**
+ * The command line arguments an argument is read from.
+ *
+ *   * value_strings: the values following the argument
+ *   * value_strings_length: the number of values
+ */
+struct arguments_strings_t {
+    char **value_strings;
+    unsigned int value_strings_length;
+};
+
+/**
+ * The operations performed by the function apply of an item.
+ */
+enum {
+    /**
+     * Executes read if the argument was passed, and set_default otherwise.
+     * The result is non-zero if the value is valid.
+     */
+    AO_CONVERT,
+
+    /**
+     * Evaluates is_required. The result is non-zero if the argument is
+     * required.
+     */
+    AO_IS_REQUIRED,
+
+    /**
+     * Executes release.
+     */
+    AO_RELEASE
+};
+
+/**
+ * The items defined in arguments.def, numbered in the order they are defined.
+ *
+ * The specialisation for an argument provides:
+ *
+ *   * value_type: the type of the value
+ *   * slot_t: a class with the value as its only, static, member, named
+ *     after the argument
+ *   * index_t: a class with AI_name as its only enumerator, named after the
+ *     argument
+ *   * identifier, short_name, help_text: the name of the argument and the
+ *     strings passed to ARGUMENT
+ *   * count_values: returns the value_count passed to ARGUMENT
+ *   * flags_target, flags_bits: -1 and 0
+ *   * value: returns the value
+ *   * apply: performs an AO_ operation by executing the blocks passed to
+ *     ARGUMENT; all blocks are in one template, so that every argument
+ *     instantiates only one
+ *
+ * The specialisation for a section only provides slot_t and index_t, which are
+ * empty, and help_text; the rest is inherited from arguments_section_t.
+ *
+ * The specialisation for an invocation of ARGUMENT_FLAGS is like that of a
+ * section without help text, and provides flags_target and flags_bits: the
+ * number of the item of the argument and its flags.
+ */
+template<int K>
+struct arguments_entry;
+
+/**
+ * The members inherited by the items of sections.
+ */
+struct arguments_section_t {
+    typedef void value_type;
+
+    static constexpr bool is_argument = false;
+    static constexpr const char *identifier = NULL;
+    static constexpr const char *short_name = NULL;
+    static constexpr int flags_target = -1;
+    static constexpr int flags_bits = 0;
+
+    static int
+    count_values(void)
+    {
+        return 0;
+    }
+
+    template<typename V, typename S>
+    static int
+    apply(int operation, V *, S *, struct arguments_arena_t *)
+    {
+        return operation == AO_CONVERT;
+    }
+};
+
+/**
+ * The first value of __COUNTER__, from which the items are numbered.
+ */
+static constexpr int arguments_counter_base = __COUNTER__;
+
+/**
+ * Returns the number of the next item.
+ */
+#define ARGUMENTS_ITEM \
+    (__COUNTER__ - arguments_counter_base - 1)
+
+#undef ARGUMENT
+#define ARGUMENT(type, name, short, help, value_count, is_required, \
+        set_default, read, release) \
+    typedef type name##_t; \
+    enum { AI_##name = ARGUMENTS_ITEM }; \
+    template<> \
+    struct arguments_entry<AI_##name> { \
+        typedef name##_t value_type; \
+        \
+        struct slot_t { \
+            static inline name##_t name; \
+        }; \
+        struct index_t { \
+            enum { name = AI_##name }; \
+        }; \
+        \
+        static constexpr bool is_argument = true; \
+        static constexpr const char *identifier = #name; \
+        static constexpr const char *short_name = short; \
+        static constexpr const char *help_text = help; \
+        static constexpr int flags_target = -1; \
+        static constexpr int flags_bits = 0; \
+        \
+        static int \
+        count_values(void) \
+        { \
+            return (int)(value_count); \
+        } \
+        \
+        static name##_t & \
+        value(void) \
+        { \
+            return slot_t::name; \
+        } \
+        \
+        template<typename V, typename S> \
+        static int \
+        apply(int operation, V *arguments_current, \
+            S *arguments_current_state, struct arguments_arena_t *arena) \
+        { \
+            int is_valid = 1; \
+            name##_t *target = &slot_t::name; \
+            char **value_strings = arguments_current_state-> \
+                arguments_strings[AI_##name].value_strings; \
+            unsigned int value_strings_length = arguments_current_state-> \
+                arguments_strings[AI_##name].value_strings_length; \
+            \
+            switch (operation) { \
+            case AO_CONVERT: \
+                if (arguments_current_state->arguments_sources[AI_##name] \
+                        != AS_DEFAULT) { \
+                    read \
+                } \
+                else { \
+                    set_default \
+                } \
+                break; \
+            \
+            case AO_IS_REQUIRED: \
+                is_valid = (is_required) != 0; \
+                break; \
+            \
+            case AO_RELEASE: \
+                do { \
+                    release \
+                } while (0); \
+                break; \
+            } \
+            \
+            if (arguments_current); \
+            if (target); \
+            if (arena); \
+            if (value_strings); \
+            if (value_strings_length); \
+            \
+            return is_valid; \
+        } \
+    };
+#undef ARGUMENT_SECTION
+#define ARGUMENT_SECTION(text) \
+    template<> \
+    struct arguments_entry<ARGUMENTS_ITEM> : arguments_section_t { \
+        struct slot_t { \
+        }; \
+        struct index_t { \
+        }; \
+        \
+        static constexpr const char *help_text = text; \
+    };
+#undef ARGUMENT_FLAGS
+#define ARGUMENT_FLAGS(name, flags) \
+    template<> \
+    struct arguments_entry<ARGUMENTS_ITEM> : arguments_section_t { \
+        struct slot_t { \
+        }; \
+        struct index_t { \
+        }; \
+        \
+        static constexpr const char *help_text = NULL; \
+        static constexpr int flags_target = AI_##name; \
+        static constexpr int flags_bits = (flags); \
+    };
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help) \
+    static_assert(false && #name, \
+        "ARGUMENT_COMMAND is not supported by arguments.hpp");
+#include "../arguments.def"
+#undef ARGUMENT_FLAGS
+#define ARGUMENT_FLAGS(name, flags)
+#undef ARGUMENT_COMMAND
+#define ARGUMENT_COMMAND(name, help)
+
+/**
+ * The number of items.
+ */
+enum {
+    ARGUMENTS_COUNT = ARGUMENTS_ITEM
+};
+
+/**
+ * The sequence of the numbers of all items.
+ */
+typedef std::make_integer_sequence<int, ARGUMENTS_COUNT> arguments_items_t;
+
+/**
+ * The storage generated from a sequence of items.
+ *
+ *   * values_t: inherits the slot of every item, so the value of an argument
+ *     is the member named after it; since the values are static members of
+ *     the slots, the blocks of an argument access the value in its own slot,
+ *     and the member is only looked up among all bases where it is named
+ *   * state_t: inherits the index of every item, so the index of an argument
+ *     is the enumerator named after it, and holds the bookkeeping of every
+ *     item, indexed by AI_name
+ */
+template<typename T>
+struct arguments_storage_of;
+
+template<int... K>
+struct arguments_storage_of<std::integer_sequence<int, K...>> {
+    struct values_t : arguments_entry<K>::slot_t... {
+    };
+
+    struct state_t : arguments_entry<K>::index_t... {
+        unsigned char arguments_sources[ARGUMENTS_COUNT + 1];
+        unsigned char arguments_initialized[ARGUMENTS_COUNT + 1];
+        struct arguments_strings_t arguments_strings[ARGUMENTS_COUNT + 1];
+    };
+};
+
+/**
+ * The parsed argument values, as members named after the arguments.
+ */
+struct arguments_t : arguments_storage_of<arguments_items_t>::values_t {
+};
+
+/**
+ * The bookkeeping of the arguments.
+ *
+ *   * arguments_sources: where every argument was found, which is AS_DEFAULT
+ *     unless it was passed
+ *   * arguments_initialized: whether every argument has been converted, and
+ *     must be released
+ *   * arguments_strings: the command line arguments every argument is read
+ *     from
+ */
+struct arguments_state_t : arguments_storage_of<arguments_items_t>::state_t {
+};
+
+/**
+ * The command line arguments that are not arguments or values.
+ *
+ *   * positional: all positional arguments, in the order they were passed
+ *   * unknown: all command line arguments that start with "-" but do not
+ *     match any argument
+ */
+struct arguments_rest_t {
+    std::vector<char*> positional;
+    std::vector<char*> unknown;
+};
+
+static struct arguments_t arguments;
+static struct arguments_state_t arguments_state;
+static struct arguments_rest_t arguments_rest;
+
+/**
+ * The arena passed to the readers.
+ */
+static struct arguments_arena_t arguments_arena;
+
+/**
+ * The values of every argument with the flag ARGUMENT_ACCUMULATE, indexed by
+ * AI_name, to which arguments_strings refers once arguments_scan returns.
+ */
+static std::vector<char*> arguments_accumulated[ARGUMENTS_COUNT + 1];
+
+/**
+ * The values and bookkeeping read by ARGUMENT_VALUE and ARGUMENT_IS_PRESENT.
+ */
+static struct arguments_t *const ARGUMENTS_UNUSED arguments_current =
+    &arguments;
+static struct arguments_state_t *const ARGUMENTS_UNUSED
+    arguments_current_state = &arguments_state;
+
+/**
+ * Returns the length of a string at compile time.
+ */
+static constexpr unsigned int
+arguments_constexpr_length(const char *s)
+{
+    unsigned int result = 0;
+
+    while (s && s[result]) {
+        result++;
+    }
+
+    return result;
+}
+
+/**
+ * The description of an item.
+ *
+ *   * identifier: the name of the argument, or NULL for sections
+ *   * long_length: the length of the long argument, or 0 for sections
+ *   * short_name: the short argument, or NULL
+ *   * help: the help text
+ *   * count_values, apply: the functions of the item
+ */
+struct arguments_descriptor_t {
+    const char *identifier;
+    unsigned int long_length;
+    const char *short_name;
+    const char *help;
+    int (*count_values)(void);
+    int (*apply)(int, struct arguments_t*, struct arguments_state_t*,
+        struct arguments_arena_t*);
+};
+
+/**
+ * The descriptor tables generated from a sequence of items.
+ *
+ *   * descriptors: the descriptors of all items, indexed by AI_name
+ *   * header_width: the number of characters needed for the argument names
+ *     in the help
+ */
+template<typename T>
+struct arguments_table_of;
+
+template<int... K>
+struct arguments_table_of<std::integer_sequence<int, K...>> {
+    static constexpr struct arguments_descriptor_t
+        descriptors[ARGUMENTS_COUNT + 1] = {
+        {
+            arguments_entry<K>::identifier,
+            arguments_entry<K>::is_argument
+                ? 2 + arguments_constexpr_length(
+                    arguments_entry<K>::identifier)
+                : 0,
+            arguments_entry<K>::short_name,
+            arguments_entry<K>::help_text,
+            &arguments_entry<K>::count_values,
+            &arguments_entry<K>::template apply<struct arguments_t,
+                struct arguments_state_t>
+        }...,
+        {NULL, 0, NULL, NULL, NULL, NULL}
+    };
+
+    static constexpr unsigned int
+    calculate_header_width(void)
+    {
+        unsigned int result = 0;
+        int i = 0;
+
+        for (; i < ARGUMENTS_COUNT; i++) {
+            unsigned int current = descriptors[i].long_length;
+
+            if (descriptors[i].short_name) {
+                current += 2
+                    + arguments_constexpr_length(descriptors[i].short_name);
+            }
+            if (current > result) {
+                result = current;
+            }
+        }
+
+        return result;
+    }
+
+    static constexpr unsigned int header_width = calculate_header_width();
+};
+
+typedef arguments_table_of<arguments_items_t> arguments_table_t;
+
+/**
+ * The descriptors of all items, indexed by AI_name.
+ */
+static constexpr const struct arguments_descriptor_t *arguments_descriptors =
+    arguments_table_t::descriptors;
+
+/**
+ * The flags generated from a sequence of items.
+ *
+ *   * targets, bits: flags_target and flags_bits of every item
+ *   * flags: the flags of every item, combined from all invocations of
+ *     ARGUMENT_FLAGS for the argument, indexed by AI_name
+ */
+template<typename T>
+struct arguments_flags_of;
+
+template<int... K>
+struct arguments_flags_of<std::integer_sequence<int, K...>> {
+    static constexpr int targets[ARGUMENTS_COUNT + 1] = {
+        arguments_entry<K>::flags_target..., -1
+    };
+    static constexpr int bits[ARGUMENTS_COUNT + 1] = {
+        arguments_entry<K>::flags_bits..., 0
+    };
+
+    static constexpr std::array<int, ARGUMENTS_COUNT + 1>
+    calculate_flags(void)
+    {
+        std::array<int, ARGUMENTS_COUNT + 1> result{};
+        int i = 0;
+
+        for (; i < ARGUMENTS_COUNT; i++) {
+            if (targets[i] >= 0) {
+                result[targets[i]] |= bits[i];
+            }
+        }
+
+        return result;
+    }
+
+    static constexpr std::array<int, ARGUMENTS_COUNT + 1> flags =
+        calculate_flags();
+};
+
+/**
+ * The flags of all items, indexed by AI_name.
+ */
+static constexpr const std::array<int, ARGUMENTS_COUNT + 1> &arguments_flags =
+    arguments_flags_of<arguments_items_t>::flags;
+
+/**
+ * The flags of the arguments that arguments_release does not release, since
+ * it is called when the process terminates.
+ */
+#if ARGUMENTS_LEAK_CHECK
+    #define arguments_kept_at_exit \
+        ARGUMENT_NO_RELEASE
+#else
+    #define arguments_kept_at_exit \
+        (ARGUMENT_NO_RELEASE | ARGUMENT_DEBUG_RELEASE)
+#endif
+
+/**
+ * The sequence of the numbers of all arguments, which are the items that are
+ * not sections or flags.
+ *
+ * The items are filtered with a loop rather than recursively, so that large
+ * definition files do not exceed the template instantiation depth.
+ */
+template<typename T>
+struct arguments_arguments_of;
+
+template<int... K>
+struct arguments_arguments_of<std::integer_sequence<int, K...>> {
+    static constexpr bool is_argument[ARGUMENTS_COUNT + 1] = {
+        arguments_entry<K>::is_argument..., false
+    };
+
+    static constexpr int
+    calculate_count(void)
+    {
+        int result = 0;
+        int i = 0;
+
+        for (; i < ARGUMENTS_COUNT; i++) {
+            result += is_argument[i];
+        }
+
+        return result;
+    }
+
+    static constexpr int count = calculate_count();
+
+    static constexpr std::array<int, count + 1>
+    calculate_items(void)
+    {
+        std::array<int, count + 1> result{};
+        int i = 0, j = 0;
+
+        for (; i < ARGUMENTS_COUNT; i++) {
+            if (is_argument[i]) {
+                result[j++] = i;
+            }
+        }
+
+        return result;
+    }
+
+    static constexpr std::array<int, count + 1> items = calculate_items();
+
+    template<std::size_t... J>
+    static std::integer_sequence<int, items[J]...>
+    select(std::index_sequence<J...>);
+
+    typedef decltype(select(std::make_index_sequence<count>())) type;
+};
+
+typedef arguments_arguments_of<arguments_items_t>::type arguments_arguments_t;
+
+/**
+ * The names of all arguments, generated at run time rather than at compile
+ * time, since generating them at compile time takes longer than everything
+ * else for large definition files.
+ *
+ *   * long_names_buffer: the long arguments, one after another
+ *   * long_names: the long argument of every item, which is the name of the
+ *     argument prepended by "--" and with all underscores replaced with
+ *     dashes, or NULL for sections, indexed by AI_name
+ *   * names: pairs of every long and short argument and the index of its
+ *     argument, sorted by the name
+ *   * short_table: the index of the argument plus 1 for every single
+ *     character short option, or 0
+ */
+struct arguments_lookup_t {
+    std::vector<char> long_names_buffer;
+    const char *long_names[ARGUMENTS_COUNT + 1];
+    std::vector<std::pair<const char*, int>> names;
+    int short_table[256];
+};
+
+/**
+ * Compares the names of two elements of arguments_lookup_t::names.
+ */
+static bool
+arguments_name_less(const std::pair<const char*, int> &a,
+    const std::pair<const char*, int> &b)
+{
+    return strcmp(a.first, b.first) < 0;
+}
+
+/**
+ * Generates the lookup tables.
+ *
+ * @param table
+ *     The lookup tables, which are empty.
+ */
+static void
+arguments_lookup_generate(struct arguments_lookup_t *table)
+{
+    char *long_name;
+    size_t size = 0;
+    int i;
+
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        size += arguments_descriptors[i].long_length + 1;
+    }
+    table->long_names_buffer.resize(size);
+    long_name = table->long_names_buffer.data();
+
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        const struct arguments_descriptor_t *d = &arguments_descriptors[i];
+        const char *c;
+
+        if (!d->identifier) {
+            continue;
+        }
+
+        table->long_names[i] = long_name;
+        *(long_name++) = '-';
+        *(long_name++) = '-';
+        for (c = d->identifier; *c; c++) {
+            *(long_name++) = (*c == '_') ? '-' : *c;
+        }
+        *(long_name++) = '\0';
+
+        table->names.emplace_back(table->long_names[i], i);
+        if (d->short_name && d->short_name[0]) {
+            table->names.emplace_back(d->short_name, i);
+            if ((d->short_name[0] == '-') && d->short_name[1]
+                    && !d->short_name[2]
+                    && !table->short_table[(unsigned char)d->short_name[1]]) {
+                table->short_table[(unsigned char)d->short_name[1]] = i + 1;
+            }
+        }
+    }
+
+    /* The first argument defined with a name wins, like in arguments.h */
+    std::stable_sort(table->names.begin(), table->names.end(),
+        arguments_name_less);
+}
+
+/**
+ * Returns the lookup tables, generating them upon the first call.
+ */
+static const struct arguments_lookup_t &
+arguments_lookup_table(void)
+{
+    static struct arguments_lookup_t table;
+    static bool is_generated = false;
+
+    if (!is_generated) {
+        arguments_lookup_generate(&table);
+        is_generated = true;
+    }
+
+    return table;
+}
+
+/**
+ * Finds the argument matching a command line argument.
+ *
+ * @param arg
+ *     The command line argument.
+ * @return the index of the argument, or -1 if no argument matches
+ */
+static int
+arguments_lookup(const char *arg)
+{
+    const struct arguments_lookup_t &table = arguments_lookup_table();
+    auto match = std::lower_bound(table.names.begin(), table.names.end(),
+        std::pair<const char*, int>(arg, 0), arguments_name_less);
+
+    return ((match != table.names.end()) && (strcmp(match->first, arg) == 0))
+        ? match->second
+        : -1;
+}
+
+/**
+ * Determines whether a command line argument looks like an argument.
+ */
+#define arguments_is_option(arg) \
+    (((arg)[0] == '-') && (arg)[1])
+
+#if ARGUMENTS_SHORT_BUNDLES
+/**
+ * Determines whether a command line argument is a bundle of single character
+ * short options, such as "-abc" for "-a -b -c".
+ *
+ * @param arg
+ *     The command line argument, which does not match any argument.
+ * @return non-zero if every character following the "-" is a single
+ *     character short option
+ */
+static int
+arguments_is_bundle(const char *arg)
+{
+    const struct arguments_lookup_t &table = arguments_lookup_table();
+    const char *c;
+
+    if ((arg[0] != '-') || !arg[1] || (arg[1] == '-')) {
+        return 0;
+    }
+    for (c = arg + 1; *c; c++) {
+        if (!table.short_table[(unsigned char)*c]) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+#endif
+
+#if ARGUMENTS_PRINT_HELP
+/**
+ * Prints the help for all arguments with a single write.
+ */
+static void
+arguments_print_help(void)
+{
+    const struct arguments_lookup_t &table = arguments_lookup_table();
+    struct arguments_help_buffer_t buffer = {NULL, 0, 0, 1};
+    unsigned int terminal_width = arguments_terminal_width();
+    int i;
+
+#ifdef ARGUMENTS_HELP
+    arguments_render_help_string(&buffer, NULL, NULL, ARGUMENTS_HELP, 0,
+        terminal_width);
+#endif
+
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        const struct arguments_descriptor_t *d = &arguments_descriptors[i];
+
+        if (d->identifier) {
+            arguments_render_help_string(&buffer, table.long_names[i],
+                d->short_name, d->help, arguments_table_t::header_width,
+                terminal_width);
+        }
+        else if (d->help) {
+            arguments_help_append(&buffer, "\n", 1);
+            arguments_render_help_string(&buffer, NULL, NULL, d->help, 0,
+                terminal_width);
+        }
+    }
+
+    if (buffer.is_valid) {
+        fwrite(buffer.data, 1, buffer.length, stdout);
+    }
+    free(buffer.data);
+}
+#endif
+
+/**
+ * Records the values of an argument passed on the command line.
+ *
+ * The values of an argument with the flag ARGUMENT_ACCUMULATE are appended to
+ * arguments_accumulated instead of replacing those of earlier occurrences.
+ *
+ * @param index
+ *     The index of the argument.
+ * @param argc, argv
+ *     The command line.
+ * @param position
+ *     The index of the first value. This is advanced past the values.
+ * @return non-zero upon success, or 0 if not enough values were passed
+ */
+static int
+arguments_take(int index, int argc, char *argv[], int *position)
+{
+    int count = arguments_descriptors[index].count_values();
+
+    if (count == ARGUMENT_VARIADIC) {
+        for (count = 0; *position + count < argc; count++) {
+            if (arguments_is_option(argv[*position + count])) {
+                break;
+            }
+        }
+    }
+    if (*position + count > argc) {
+        return 0;
+    }
+
+    arguments_state.arguments_sources[index] = AS_COMMAND_LINE;
+    if (arguments_flags[index] & ARGUMENT_ACCUMULATE) {
+        arguments_accumulated[index].insert(arguments_accumulated[index].end(),
+            argv + *position, argv + *position + count);
+    }
+    else {
+        arguments_state.arguments_strings[index].value_strings =
+            argv + *position;
+        arguments_state.arguments_strings[index].value_strings_length = count;
+    }
+    *position += count;
+
+    return 1;
+}
+
+/**
+ * Parses the entire command line given by argv and argc.
+ *
+ * Command line arguments that do not match any argument are collected in
+ * arguments_rest: those starting with "-" are unknown, and any others are
+ * positional. All command line arguments following "--" are positional. If
+ * ARGUMENTS_PERMUTE is zero, the first positional argument and all command
+ * line arguments following it are positional.
+ *
+ * The values of all occurrences of an argument with the flag
+ * ARGUMENT_ACCUMULATE are passed to read, in the order they were passed.
+ *
+ * @param argc, argv
+ *     The command line.
+ * @return AC_OK if no error occurred, AC_HELP if --help was encountered and
+ *     ARGUMENTS_PRINT_HELP was non-zero, or AC_ERROR if an argument was not
+ *     passed enough values
+ */
+static int
+arguments_scan(int argc, char *argv[])
+{
+    int nextarg = 1;
+    int i;
+
+    while (nextarg < argc) {
+        char *arg = argv[nextarg];
+        int index, position = nextarg + 1;
+
+#if ARGUMENTS_PRINT_HELP
+        if ((strcmp(arg, "--help") == 0) || (strcmp(arg, "-h") == 0)) {
+            arguments_print_help();
+            return AC_HELP;
+        }
+#endif
+
+        index = arguments_lookup(arg);
+        if (index >= 0) {
+            if (!arguments_take(index, argc, argv, &position)) {
+                return AC_ERROR;
+            }
+            nextarg = position;
+        }
+#if ARGUMENTS_SHORT_BUNDLES
+        else if (arguments_is_bundle(arg)) {
+            /* The arguments of a bundle read their values in turn from the
+               command line arguments following the bundle */
+            const struct arguments_lookup_t &table = arguments_lookup_table();
+            const char *c;
+
+            for (c = arg + 1; *c; c++) {
+                if (!arguments_take(table.short_table[(unsigned char)*c] - 1,
+                        argc, argv, &position)) {
+                    return AC_ERROR;
+                }
+            }
+            nextarg = position;
+        }
+#endif
+        else if (strcmp(arg, "--") == 0) {
+            arguments_rest.positional.insert(arguments_rest.positional.end(),
+                argv + nextarg + 1, argv + argc);
+            break;
+        }
+        else if (arguments_is_option(arg)) {
+            arguments_rest.unknown.push_back(arg);
+            nextarg++;
+        }
+        else {
+#if ARGUMENTS_PERMUTE
+            arguments_rest.positional.push_back(arg);
+            nextarg++;
+#else
+            arguments_rest.positional.insert(arguments_rest.positional.end(),
+                argv + nextarg, argv + argc);
+            break;
+#endif
+        }
+    }
+
+    /* The accumulated values no longer move once the command line has been
+       read */
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        if (arguments_flags[i] & ARGUMENT_ACCUMULATE) {
+            arguments_state.arguments_strings[i].value_strings =
+                arguments_accumulated[i].data();
+            arguments_state.arguments_strings[i].value_strings_length =
+                arguments_accumulated[i].size();
+        }
+    }
+
+    return AC_OK;
+}
+
+/**
+ * Verifies that all required arguments have been passed.
+ *
+ * If ARGUMENTS_PRINT_MISSING_FORMAT is defined, the name of the first missing
+ * argument is printed to stderr with this format.
+ *
+ * @return AC_OK if all required arguments have been passed, or AC_ERROR
+ *     otherwise
+ */
+static int
+arguments_check(void)
+{
+    int i;
+
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        if ((arguments_state.arguments_sources[i] == AS_DEFAULT)
+                && arguments_descriptors[i].apply(AO_IS_REQUIRED,
+                    &arguments, &arguments_state, &arguments_arena)) {
+#ifdef ARGUMENTS_PRINT_MISSING_FORMAT
+            fprintf(stderr, ARGUMENTS_PRINT_MISSING_FORMAT,
+                arguments_descriptors[i].identifier);
+#endif
+            return AC_ERROR;
+        }
+    }
+
+    return AC_OK;
+}
+
+/**
+ * Releases all converted values, in the order the arguments are defined, and
+ * the memory allocated from the arena.
+ *
+ * This is registered by arguments_set to be called when the process
+ * terminates, so arguments with the flag ARGUMENT_NO_RELEASE, and unless
+ * ARGUMENTS_LEAK_CHECK is non-zero those with the flag ARGUMENT_DEBUG_RELEASE,
+ * are not released.
+ */
+static void
+arguments_release(void)
+{
+    int i;
+
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        if (arguments_state.arguments_initialized[i]
+                && !(arguments_flags[i] & arguments_kept_at_exit)) {
+            arguments_descriptors[i].apply(AO_RELEASE, &arguments,
+                &arguments_state, &arguments_arena);
+            arguments_state.arguments_initialized[i] = 0;
+        }
+    }
+
+    arguments_arena_release(&arguments_arena);
+}
+
+/**
+ * Converts the values of all arguments, in the order they are defined.
+ *
+ * The values of the arguments that were passed are read, and the others are
+ * set to their defaults. Conversion stops at the first invalid value.
+ *
+ * @return AC_OK if all values are valid, or AC_ERROR otherwise
+ */
+static int
+arguments_set(void)
+{
+    int i;
+
+    atexit(arguments_release);
+
+    for (i = 0; i < ARGUMENTS_COUNT; i++) {
+        if (!arguments_descriptors[i].apply(AO_CONVERT, &arguments,
+                &arguments_state, &arguments_arena)) {
+            return AC_ERROR;
+        }
+        arguments_state.arguments_initialized[i] = 1;
+    }
+
+    return AC_OK;
+}
+
+#if ARGUMENTS_AUTOMATIC
+
+/**
+ * The signature of run, generated from a sequence of arguments.
+ *
+ *   * type: the function type of run, which matches that of main with the
+ *     values of all arguments added in the order they are defined
+ *   * call: calls run with the parsed values
+ */
+template<typename T>
+struct arguments_run_of;
+
+template<int... K>
+struct arguments_run_of<std::integer_sequence<int, K...>> {
+    typedef int type(int, char**,
+        typename arguments_entry<K>::value_type...);
+
+    static int
+    call(type *function, int argc, char *argv[])
+    {
+        return function(argc, argv, arguments_entry<K>::value()...);
+    }
+};
+
+typedef arguments_run_of<arguments_arguments_t> arguments_run_t;
+
+/**
+ * This function is called after the presence of all required arguments has
+ * been verified, but before any arguments are converted to actual values.
+ *
+ * If you do not need any setup, define ARGUMENTS_NO_SETUP.
+ *
+ * @param argc, argv
+ *     The parameters passed to main.
+ * @return 0 upon success and the application return code otherwise
+ */
+static int
+arguments_setup(int argc, char *argv[])
+#ifdef ARGUMENTS_NO_SETUP
+{
+    (void)argc;
+    (void)argv;
+
+    return 0;
+}
+#else
+;
+#endif
+
+/**
+ * This is the function called by main once the arguments have been parsed.
+ *
+ * Its signature matches that of main with all arguments found in
+ * arguments.def added to the argument list as well.
+ */
+static arguments_run_t::type run;
+
+/**
+ * This function is called when the program terminates, if arguments_setup
+ * succeeded.
+ *
+ * If you do not need any teardown, define ARGUMENTS_NO_TEARDOWN.
+ */
+static void
+arguments_teardown(void)
+#ifdef ARGUMENTS_NO_TEARDOWN
+{
+}
+#else
+;
+#endif
+
+int
+main(int argc, char *argv[])
+{
+    int result;
+
+    /* First parse the arguments */
+    switch (arguments_scan(argc, argv)) {
+    case AC_OK:
+        break;
+
+    case AC_HELP:
+        return 0;
+
+    default:
+        return ARGUMENTS_PARAMETER_INVALID;
+    }
+
+    /* Detect missing arguments */
+    if (arguments_check() != AC_OK) {
+        return ARGUMENTS_PARAMETER_MISSING;
+    }
+
+    /* Call setup before converting the parameter values to variables */
+    result = arguments_setup(argc, argv);
+    if (result != 0) {
+        return result;
+    }
+    atexit(arguments_teardown);
+
+    if (arguments_set() != AC_OK) {
+        return ARGUMENTS_PARAMETER_INVALID;
+    }
+
+    return arguments_run_t::call(run, argc, argv);
+}
+
+#define main run
+
+#endif
@@ -0,0 +1,37 @@
+/*
+ * Parses and converts the command line with arguments.hpp, or with arguments.h
+ * compiled as C++ if BENCH_C is defined, so that bench.sh can compare the
+ * compile times of both front-ends.
+ *
+ * Usage: bench-cpp [ARGUMENT...]
+ */
+#define ARGUMENTS_AUTOMATIC 0
+#define ARGUMENTS_NO_SETUP
+#define ARGUMENTS_NO_TEARDOWN
+
+#ifdef BENCH_C
+    #include "arguments.h"
+#else
+    #include "arguments.hpp"
+#endif
+
+int
+main(int argc, char *argv[])
+{
+#ifdef BENCH_C
+    arguments_initialize();
+
+    if ((arguments_scan(argc, argv) != AC_OK)
+            || (arguments_check(&arguments_context) != AC_OK)
+            || (arguments_set() != AC_OK)) {
+        return 1;
+    }
+#else
+    if ((arguments_scan(argc, argv) != AC_OK) || (arguments_check() != AC_OK)
+            || (arguments_set() != AC_OK)) {
+        return 1;
+    }
+#endif
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * Times the parser on the command line in a file written by gen-argv.sh, for
+ * the arguments.def in the parent directory of the headers.
+ *
+ * Usage: bench ARGV-FILE [REPEAT]
+ *
+ * Prints, on one line:
+ *   - scan: the time arguments_scan_ctx takes per token of the command line;
+ *   - set: the time arguments_check and arguments_set_ctx take to convert
+ *     the values, which is what arguments_set does for the global variables;
+ *   - reset: the time arguments_reset_ctx takes to release the values, which
+ *     is what arguments_release does for the global variables;
+ *   - help: the time the first --help takes, including preparing the long
+ *     arguments, and the time rendering the help takes afterwards.
+ */
+#define ARGUMENTS_AUTOMATIC 0
+#define ARGUMENTS_NO_SETUP
+#define ARGUMENTS_NO_TEARDOWN
+
+#include <time.h>
+
+#include "arguments.h"
+
+/**
+ * Returns the time of a monotonic clock in nanoseconds.
+ */
+static double
+bench_now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+/**
+ * Reads the tokens of a command line, one per line, from a file.
+ *
+ * @param path
+ *     The path of the file.
+ * @param argc
+ *     The number of tokens, including the program name, is written to this
+ *     variable.
+ * @return the command line, or NULL if the file could not be read
+ */
+static char **
+bench_read_argv(const char *path, int *argc)
+{
+    FILE *file = fopen(path, "r");
+    char **argv = malloc(2 * sizeof(*argv));
+    size_t capacity = 2;
+    char line[4096];
+
+    if (!file || !argv) {
+        return NULL;
+    }
+
+    *argc = 0;
+    argv[(*argc)++] = "bench";
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\n")] = '\0';
+        if ((size_t)*argc + 1 >= capacity) {
+            capacity *= 2;
+            argv = realloc(argv, capacity * sizeof(*argv));
+            if (!argv) {
+                return NULL;
+            }
+        }
+        argv[(*argc)++] = strdup(line);
+    }
+    argv[*argc] = NULL;
+    fclose(file);
+
+    return argv;
+}
+
+int
+main(int argc, char *argv[])
+{
+    struct arguments_context_t *ctx;
+    struct arguments_help_buffer_t buffer;
+    double scan = 0, set = 0, reset = 0, first, render, start;
+    char **tokens;
+    size_t length;
+    int count, repeat, i;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s ARGV-FILE [REPEAT]\n", argv[0]);
+        return 1;
+    }
+
+    tokens = bench_read_argv(argv[1], &count);
+    ctx = arguments_create_ctx();
+    if (!tokens || !ctx) {
+        fprintf(stderr, "%s: cannot read %s\n", argv[0], argv[1]);
+        return 1;
+    }
+
+    /* Parse about two million tokens unless told otherwise */
+    repeat = (argc > 2) ? atoi(argv[2]) : 2000000 / count + 1;
+
+    arguments_initialize();
+
+    /* The first --help also generates the long arguments, so it comes
+       first */
+    start = bench_now();
+    if (!arguments_help_text(&length)) {
+        return 1;
+    }
+    first = bench_now() - start;
+
+    for (i = 0; i < repeat; i++) {
+        start = bench_now();
+        arguments_reset_ctx(ctx);
+        reset += bench_now() - start;
+
+        start = bench_now();
+        if (arguments_scan_ctx(ctx, count, tokens) != AC_OK) {
+            fprintf(stderr, "%s: the command line is invalid\n", argv[0]);
+            return 1;
+        }
+        scan += bench_now() - start;
+
+        start = bench_now();
+        if ((arguments_check(ctx) != AC_OK)
+                || (arguments_set_ctx(ctx) != AC_OK)) {
+            fprintf(stderr, "%s: the values are invalid\n", argv[0]);
+            return 1;
+        }
+        set += bench_now() - start;
+    }
+
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.is_valid = 1;
+    start = bench_now();
+    for (i = 0; i < 10; i++) {
+        buffer.length = 0;
+        arguments_render_help(&buffer, 80);
+    }
+    render = (bench_now() - start) / 10;
+
+    printf("args=%d tokens=%d scan=%.1fns/token set=%.1fus reset=%.1fus "
+        "help=%.1fus render=%.1fus\n", ARGUMENTS_COUNT, count - 1,
+        scan / repeat / (count - 1), set / repeat / 1e3,
+        reset / repeat / 1e3, first / 1e3, render / 1e3);
+
+    free(buffer.data);
+    arguments_release_ctx(ctx);
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+#!/bin/sh
+#
+# Builds bench.c for definitions of increasing size, with both dispatch modes,
+# and times compiling, parsing, converting and printing the help. It then
+# times compiling bench-cpp.cpp with arguments.hpp and with arguments.h.
+#
+# Usage: bench.sh [COUNT...]
+#
+# The counts default to 10 100 1000 10000. CC, CFLAGS, CXX and CXXFLAGS are
+# honoured, and the files are written to the directory work.
+
+set -e
+
+cd "$(dirname "$0")"
+
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2}
+CXX=${CXX:-c++}
+CXXFLAGS=${CXXFLAGS:-$CFLAGS}
+TOKENS=${TOKENS:-10000}
+
+[ $# -gt 0 ] || set -- 10 100 1000 10000
+
+for count in "$@"; do
+    dir=work/bench-$count
+    mkdir -p "$dir/lib"
+    cp ../*.h ../*.hpp "$dir/lib"
+    ./gen-def.sh "$count" > "$dir/arguments.def"
+    for kind in long short bundle positional unknown; do
+        ./gen-argv.sh "$count" "$TOKENS" "$kind" > "$dir/$kind.txt"
+    done
+
+    for hash in 0 1; do
+        start=$(date +%s%N)
+        $CC $CFLAGS -DARGUMENTS_DISPATCH_HASH=$hash -I"$dir/lib" \
+            -o "$dir/bench-$hash" bench.c
+        end=$(date +%s%N)
+        echo "args=$count hash=$hash compile=$(( (end - start) / 1000000 ))ms"
+
+        for kind in long short bundle positional unknown; do
+            printf '    %-10s ' "$kind"
+            "$dir/bench-$hash" "$dir/$kind.txt"
+        done
+    done
+
+    # The C++ front-end against the C front-end compiled as C++
+    for front in hpp h; do
+        define=
+        [ "$front" = hpp ] || define=-DBENCH_C
+        start=$(date +%s%N)
+        $CXX -std=c++17 $CXXFLAGS $define -I"$dir/lib" \
+            -o "$dir/bench-cpp-$front" bench-cpp.cpp
+        end=$(date +%s%N)
+        echo "args=$count front=$front compile=$(( (end - start) / 1000000 ))ms"
+        "$dir/bench-cpp-$front" -a --option-1 1
+    done
+done
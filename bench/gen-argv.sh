@@ -0,0 +1,69 @@
+#!/bin/sh
+#
+# Writes a command line for an arguments.def written by gen-def.sh to stdout,
+# one token per line.
+#
+# Usage: gen-argv.sh COUNT TOKENS KIND
+#
+# COUNT is the number of arguments passed to gen-def.sh and TOKENS the
+# approximate number of tokens to write. KIND is one of:
+#
+#   long        long arguments spread over all arguments, with their values
+#   short       short arguments, with their values
+#   bundle      bundles of up to 8 short flags
+#   positional  positional arguments only
+#   unknown     long arguments that match no argument
+
+count=${1:?usage: gen-argv.sh COUNT TOKENS KIND}
+tokens=${2:?usage: gen-argv.sh COUNT TOKENS KIND}
+kind=${3:?usage: gen-argv.sh COUNT TOKENS KIND}
+
+awk -v count="$count" -v tokens="$tokens" -v kind="$kind" '
+function values(i) {
+    if (i % 4 == 1) { print i; return 1 }
+    if (i % 4 == 2) { print "value" i; return 1 }
+    if (i % 4 == 3) { print "a"; print "b"; return 2 }
+    return 0
+}
+BEGIN {
+    shorts = "abcdefgijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    nshorts = (count < length(shorts)) ? count : length(shorts)
+    if (kind == "bundle") {
+        flags = ""
+        for (i = 0; i < nshorts; i += 4) {
+            flags = flags substr(shorts, i + 1, 1)
+        }
+    }
+    n = 0
+    for (k = 0; n < tokens; k++) {
+        # A prime stride visits every argument in a scattered order
+        i = (k * 7919) % count
+        if (kind == "long") {
+            name = "--option-" i
+            print name
+            n += 1 + values(i)
+        }
+        else if (kind == "short") {
+            i = k % nshorts
+            print "-" substr(shorts, i + 1, 1)
+            n += 1 + values(i)
+        }
+        else if (kind == "bundle") {
+            print "-" substr(flags, 1, 1 + k % (length(flags) < 8 \
+                ? length(flags) : 8))
+            n++
+        }
+        else if (kind == "positional") {
+            print "file" k
+            n++
+        }
+        else if (kind == "unknown") {
+            print "--no-such-option-" i
+            n++
+        }
+        else {
+            print "unknown kind " kind > "/dev/stderr"
+            exit 1
+        }
+    }
+}'
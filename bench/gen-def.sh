@@ -0,0 +1,54 @@
+#!/bin/sh
+#
+# Writes an arguments.def with the given number of arguments to stdout.
+#
+# Argument i is named option_i and is, depending on i modulo 4, a flag, an
+# integer, a string or a variadic argument counting its values; the first
+# arguments also get a short name. gen-argv.sh relies on this layout.
+#
+# Usage: gen-def.sh COUNT
+
+count=${1:?usage: gen-def.sh COUNT}
+
+cat <<'END'
+#ifndef ARGUMENT_HELPERS
+#define ARGUMENT_HELPERS
+
+#include <stdlib.h>
+
+#endif
+
+ARGUMENT_SECTION("Benchmark options")
+
+END
+
+awk -v count="$count" 'BEGIN {
+    shorts = "abcdefgijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    for (i = 0; i < count; i++) {
+        short = (i < length(shorts)) \
+            ? "\"-" substr(shorts, i + 1, 1) "\"" : "NULL"
+        help = "\"Option number " i " of the benchmark, which is " \
+            "described by a sentence long enough to be wrapped.\""
+        kind = i % 4
+        if (kind == 0) {
+            print "ARGUMENT(int, option_" i ", " short ",\n    " help ", 0,"
+            print "    ARGUMENT_IS_OPTIONAL, *target = 0;, *target = 1;, )"
+        }
+        else if (kind == 1) {
+            print "ARGUMENT(int, option_" i ", " short ",\n    " help ", 1,"
+            print "    ARGUMENT_IS_OPTIONAL, *target = 0;,"
+            print "    *target = atoi(value_strings[0]);, )"
+        }
+        else if (kind == 2) {
+            print "ARGUMENT(const char*, option_" i ", " short ",\n    " \
+                help ", 1,"
+            print "    ARGUMENT_IS_OPTIONAL, *target = NULL;,"
+            print "    *target = value_strings[0];, )"
+        }
+        else {
+            print "ARGUMENT(int, option_" i ", " short ",\n    " help ","
+            print "    ARGUMENT_VARIADIC, ARGUMENT_IS_OPTIONAL, *target = 0;,"
+            print "    *target = value_strings_length;, )"
+        }
+    }
+}'
@@ -0,0 +1,269 @@
+/*
+ * Parses a worst case command line, or renders the help, on a thread with a
+ * small stack, and fails if this takes too long or too much memory.
+ *
+ * Usage: stress CASE COUNT SECONDS KILOBYTES [RESPONSE-FILE]
+ *
+ * COUNT is the number of tokens, or the length of the single token, of the
+ * command line described by CASE:
+ *
+ *   long        a long argument with a value, repeated
+ *   unknown     long arguments that match no argument
+ *   positional  positional arguments only
+ *   variadic    a variadic argument followed by COUNT - 1 values
+ *   accumulate  an accumulated argument with a value, repeated
+ *   bundle      a bundle of COUNT short flags
+ *   badbundle   a bundle of COUNT short flags ending with an unknown one
+ *   longname    ten long arguments of COUNT characters matching nothing
+ *   longprefix  ten long arguments of COUNT characters extending a name
+ *   response    a response file, written by gen-argv.sh, of COUNT tokens
+ *   help        the help, rendered COUNT times at widths of 80 and 33
+ *
+ * The process exits with 1 if the arguments were not parsed as expected, or
+ * if the time or the maximum resident set size exceeds SECONDS or KILOBYTES.
+ */
+#define ARGUMENTS_AUTOMATIC 0
+#define ARGUMENTS_NO_SETUP
+#define ARGUMENTS_NO_TEARDOWN
+#define ARGUMENTS_RESPONSE_FILES 1
+
+#include <pthread.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include "arguments.h"
+
+/**
+ * The stack size of the thread parsing the command line.
+ */
+#define STRESS_STACK_SIZE (64 * 1024)
+
+static const char *stress_case;
+static long stress_count;
+static int stress_argc;
+static char **stress_argv;
+static int stress_is_valid;
+
+/**
+ * Builds the command line for a case.
+ *
+ * @return non-zero upon success, or 0 if the case is unknown or memory could
+ *     not be allocated
+ */
+static int
+stress_build(const char *path)
+{
+    long n = stress_count, i;
+    char *token = NULL;
+
+    stress_argv = malloc((n + 4) * sizeof(*stress_argv));
+    if (!stress_argv) {
+        return 0;
+    }
+    stress_argc = 0;
+    stress_argv[stress_argc++] = "stress";
+
+    if (!strcmp(stress_case, "long")) {
+        for (i = 0; i < n / 2; i++) {
+            stress_argv[stress_argc++] = "--option-1";
+            stress_argv[stress_argc++] = "1";
+        }
+    }
+    else if (!strcmp(stress_case, "unknown")) {
+        for (i = 0; i < n; i++) {
+            stress_argv[stress_argc++] = "--option-499x";
+        }
+    }
+    else if (!strcmp(stress_case, "positional")) {
+        for (i = 0; i < n; i++) {
+            stress_argv[stress_argc++] = "file";
+        }
+    }
+    else if (!strcmp(stress_case, "variadic")) {
+        stress_argv[stress_argc++] = "-d";
+        for (i = 1; i < n; i++) {
+            stress_argv[stress_argc++] = "x";
+        }
+    }
+    else if (!strcmp(stress_case, "accumulate")) {
+        for (i = 0; i < n / 2; i++) {
+            stress_argv[stress_argc++] = "-b";
+            stress_argv[stress_argc++] = "1";
+        }
+    }
+    else if (!strcmp(stress_case, "bundle")
+            || !strcmp(stress_case, "badbundle")) {
+        token = malloc(n + 3);
+        if (!token) {
+            return 0;
+        }
+        token[0] = '-';
+        memset(token + 1, 'a', n);
+        token[n] = !strcmp(stress_case, "bundle") ? 'a' : '0';
+        token[n + 1] = '\0';
+        stress_argv[stress_argc++] = token;
+    }
+    else if (!strcmp(stress_case, "longname")
+            || !strcmp(stress_case, "longprefix")) {
+        token = malloc(n + 3);
+        if (!token) {
+            return 0;
+        }
+        memset(token, '1', n);
+        if (!strcmp(stress_case, "longname")) {
+            memcpy(token, "--x", 3);
+        }
+        else {
+            memcpy(token, "--option-1", 10);
+        }
+        token[n] = '\0';
+        for (i = 0; i < 10; i++) {
+            stress_argv[stress_argc++] = token;
+        }
+    }
+    else if (!strcmp(stress_case, "response")) {
+        static char response[4096];
+
+        if (!path || (strlen(path) + 2 > sizeof(response))) {
+            return 0;
+        }
+        response[0] = '@';
+        strcpy(response + 1, path);
+        stress_argv[stress_argc++] = response;
+    }
+    else if (strcmp(stress_case, "help")) {
+        return 0;
+    }
+
+    stress_argv[stress_argc] = NULL;
+
+    return 1;
+}
+
+/**
+ * Renders the help at two widths.
+ *
+ * @return non-zero if the help could be rendered
+ */
+static int
+stress_help(void)
+{
+    struct arguments_help_buffer_t buffer;
+    long i;
+
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.is_valid = 1;
+    for (i = 0; buffer.is_valid && (i < stress_count); i++) {
+        buffer.length = 0;
+        arguments_render_help(&buffer, 80);
+        buffer.length = 0;
+        arguments_render_help(&buffer, 33);
+    }
+    free(buffer.data);
+
+    return buffer.is_valid;
+}
+
+/**
+ * Parses the command line of the case and verifies the result.
+ */
+static void *
+stress_parse(void *arg)
+{
+    struct arguments_context_t *ctx;
+    int argc = stress_argc, result;
+    char **argv = stress_argv;
+
+    (void)arg;
+    if (!strcmp(stress_case, "help")) {
+        stress_is_valid = stress_help();
+        return NULL;
+    }
+
+    ctx = arguments_create_ctx();
+    if (!ctx) {
+        return NULL;
+    }
+    result = arguments_parse_ctx(ctx, argc, argv);
+    if (ctx->responses.argv) {
+        argc = ctx->responses.argc;
+    }
+
+    if (!strcmp(stress_case, "long") || !strcmp(stress_case, "response")) {
+        stress_is_valid = (result == AC_OK) && ctx->values->option_1;
+    }
+    else if (!strcmp(stress_case, "unknown")
+            || !strcmp(stress_case, "longname")
+            || !strcmp(stress_case, "longprefix")) {
+        stress_is_valid = (result == AC_OK)
+            && (ctx->rest->unknown.count == (unsigned int)argc - 1);
+    }
+    else if (!strcmp(stress_case, "positional")) {
+        stress_is_valid = (result == AC_OK)
+            && (ctx->rest->positional.count == stress_count);
+    }
+    else if (!strcmp(stress_case, "variadic")) {
+        stress_is_valid = (result == AC_OK)
+            && (ctx->values->option_3 == stress_count - 1);
+    }
+    else if (!strcmp(stress_case, "accumulate")) {
+        stress_is_valid = (result == AC_OK) && (ctx->values->option_1 == 1);
+    }
+    else if (!strcmp(stress_case, "bundle")) {
+        stress_is_valid = (result == AC_OK) && ctx->values->option_0;
+    }
+    else {
+        /* The bundle ends with a flag that is not a short name */
+        stress_is_valid = (result == AC_OK)
+            && (ctx->rest->unknown.count == 1);
+    }
+
+    arguments_release_ctx(ctx);
+
+    return NULL;
+}
+
+int
+main(int argc, char *argv[])
+{
+    struct timespec start, end;
+    struct rusage usage;
+    pthread_attr_t attributes;
+    pthread_t thread;
+    double seconds;
+
+    if (argc < 5) {
+        fprintf(stderr, "usage: %s CASE COUNT SECONDS KILOBYTES "
+            "[RESPONSE-FILE]\n", argv[0]);
+        return 1;
+    }
+    stress_case = argv[1];
+    stress_count = atol(argv[2]);
+
+    if (!stress_build((argc > 5) ? argv[5] : NULL)) {
+        fprintf(stderr, "%s: cannot build the case %s\n", argv[0],
+            stress_case);
+        return 1;
+    }
+
+    arguments_initialize();
+
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, STRESS_STACK_SIZE);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (pthread_create(&thread, &attributes, stress_parse, NULL)) {
+        fprintf(stderr, "%s: cannot start a thread\n", argv[0]);
+        return 1;
+    }
+    pthread_join(thread, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    getrusage(RUSAGE_SELF, &usage);
+
+    seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("%-10s count=%ld time=%.3fs maxrss=%ldKB %s\n", stress_case,
+        stress_count, seconds, usage.ru_maxrss,
+        stress_is_valid ? "ok" : "invalid");
+
+    return !stress_is_valid || (seconds > atof(argv[3]))
+        || (usage.ru_maxrss > atol(argv[4]));
+}
@@ -0,0 +1,71 @@
+#!/bin/sh
+#
+# Builds stress.c for 500 arguments, some of them with help texts of about a
+# megabyte, and runs every worst case with bounds on the time and on the
+# maximum resident set size. Exits with 1 if any case fails.
+#
+# Usage: stress.sh
+#
+# CC and CFLAGS are honoured, and the files are written to the directory
+# work/stress.
+
+set -e
+
+cd "$(dirname "$0")"
+
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2}
+
+dir=work/stress
+mkdir -p "$dir/lib"
+cp ../*.h "$dir/lib"
+
+{
+    ./gen-def.sh 500
+    echo "ARGUMENT_FLAGS(option_1, ARGUMENT_ACCUMULATE)"
+    echo
+    echo 'ARGUMENT_SECTION("Huge help texts")'
+    echo
+    awk 'function huge(name, word, count,    i) {
+        printf "ARGUMENT(int, %s, NULL,\n    \"", name
+        for (i = 0; i < count; i++) {
+            printf "%s", word
+        }
+        print "\", 0,"
+        print "    ARGUMENT_IS_OPTIONAL, *target = 0;, *target = 1;, )"
+    }
+    BEGIN {
+        huge("huge_word", "x", 1000000)
+        huge("huge_words", "word ", 200000)
+        huge("huge_lines", "line\\n", 200000)
+        huge("huge_multibyte", "\\303\\251", 500000)
+    }'
+} > "$dir/arguments.def"
+
+./gen-argv.sh 500 1000000 long > "$dir/response.txt"
+
+$CC $CFLAGS -I"$dir/lib" -o "$dir/stress" stress.c -lpthread
+
+status=0
+
+# Runs a case: the case, the count, and the bounds in seconds and kilobytes
+check() {
+    "$dir/stress" "$@" "$dir/response.txt" || {
+        echo "FAILED: $1 $2 (bounds $3s, $4KB)"
+        status=1
+    }
+}
+
+check long 1000000 2 65536
+check unknown 1000000 2 65536
+check positional 1000000 2 65536
+check variadic 1000000 2 65536
+check accumulate 1000000 2 65536
+check bundle 1000000 2 32768
+check badbundle 1000000 2 32768
+check longname 1000000 2 32768
+check longprefix 1000000 2 32768
+check response 1000000 2 131072
+check help 10 10 131072
+
+exit $status